@@ -0,0 +1,122 @@
+#include "fixture.h"
+
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    const char* const Syllables[] = {
+        "ka", "lo", "mi", "ne", "ru", "sa", "to", "vi", "de", "po",
+        "ra", "ni", "ko", "le", "mu", "ta", "si", "ve", "do", "pa"
+    };
+    const std::size_t SyllableCount = sizeof(Syllables) / sizeof(Syllables[0]);
+    const std::size_t SaveBatchSize = 200;
+}
+
+BenchFixture::BenchFixture(uint32_t seed, std::size_t vocabularySize)
+    : rng_(seed)
+{
+    //   2-4   :     
+    vocabulary_.reserve(vocabularySize);
+    for (std::size_t i = 0; vocabulary_.size() < vocabularySize; ++i) {
+        std::string word;
+        std::size_t n = i;
+        do {
+            word += Syllables[n % SyllableCount];
+            n /= SyllableCount;
+        } while (n != 0);
+        if (word.size() < 4) word += "ka";
+        vocabulary_.push_back(word);
+    }
+
+    //     k  1/k
+    cumulative_.reserve(vocabularySize);
+    double sum = 0;
+    for (std::size_t k = 1; k <= vocabularySize; ++k) {
+        sum += 1.0 / static_cast<double>(k);
+        cumulative_.push_back(sum);
+    }
+    for (auto& value : cumulative_) value /= sum;
+}
+
+double BenchFixture::uniform() {
+    //  std::uniform_real_distribution:     
+    return static_cast<double>(rng_()) / (static_cast<double>(std::mt19937::max()) + 1.0);
+}
+
+const std::string& BenchFixture::randomWord() {
+    auto it = std::lower_bound(cumulative_.begin(), cumulative_.end(), uniform());
+    std::size_t index = std::min<std::size_t>(it - cumulative_.begin(), vocabulary_.size() - 1);
+    return vocabulary_[index];
+}
+
+void BenchFixture::seedDatabase(Database& db, std::size_t documents, std::size_t wordsPerDocument,
+    const std::string& urlPrefix) {
+    std::vector<ParsedDocument> batch;
+    batch.reserve(SaveBatchSize);
+
+    for (std::size_t i = 0; i < documents; ++i) {
+        std::string title;
+        std::string content;
+        for (std::size_t w = 0; w < wordsPerDocument; ++w) {
+            const std::string& word = randomWord();
+            if (w < 5) title += (w ? " " : "") + word;
+            content += word;
+            content += (w % 12 == 11) ? ".\n" : " ";
+        }
+
+        batch.push_back(parseDocument(urlPrefix + std::to_string(i), title, content));
+        if (batch.size() >= SaveBatchSize || i + 1 == documents) {
+            db.saveDocuments(batch);
+            batch.clear();
+            std::cout << "Seeded " << i + 1 << " / " << documents << " documents\r" << std::flush;
+        }
+    }
+    std::cout << "\n";
+}
+
+std::vector<std::vector<std::string>> BenchFixture::searchQueries(std::size_t queries) {
+    std::vector<std::vector<std::string>> result(queries);
+    for (auto& words : result) {
+        std::size_t count = 1 + rng_() % 3;
+        for (std::size_t w = 0; w < count; ++w) {
+            words.push_back(randomWord());
+        }
+    }
+    return result;
+}
+
+void BenchFixture::writeQueryLog(const std::string& path, std::size_t queries) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to create query log: " + path);
+    }
+
+    //     :   ,    
+    for (std::size_t i = 0; i < queries; ++i) {
+        double kind = uniform();
+        if (kind < 0.6) {
+            std::size_t words = 1 + rng_() % 3;
+            for (std::size_t w = 0; w < words; ++w) {
+                out << (w ? " " : "") << randomWord();
+            }
+            out << "\n";
+        }
+        else if (kind < 0.75) {
+            out << "POST /api/search {\"query\":\"" << randomWord() << " " << randomWord() << "\",\"limit\":10}\n";
+        }
+        else if (kind < 0.95) {
+            const std::string& word = randomWord();
+            out << "GET /suggest?q=" << word.substr(0, 2 + rng_() % (word.size() - 1)) << "\n";
+        }
+        else {
+            out << "GET /\n";
+        }
+    }
+
+    if (!out.flush()) {
+        throw std::runtime_error("Failed to write query log: " + path);
+    }
+}
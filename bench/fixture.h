@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include "database.h"
+
+//     :   
+//  ,        .
+//        .
+class BenchFixture {
+public:
+    BenchFixture(uint32_t seed, std::size_t vocabularySize);
+
+    void seedDatabase(Database& db, std::size_t documents, std::size_t wordsPerDocument,
+        const std::string& urlPrefix);
+    void writeQueryLog(const std::string& path, std::size_t queries);
+    std::vector<std::vector<std::string>> searchQueries(std::size_t queries);
+
+private:
+    const std::string& randomWord();
+    double uniform();
+
+    std::mt19937 rng_;
+    std::vector<std::string> vocabulary_;
+    std::vector<double> cumulative_;
+};
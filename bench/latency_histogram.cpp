@@ -0,0 +1,77 @@
+#include "latency_histogram.h"
+#include <algorithm>
+
+namespace {
+    //  128   ,       64 
+    const unsigned SubBucketBits = 7;
+    const uint64_t SubBucketCount = 1ULL << SubBucketBits;
+    const uint64_t HalfCount = SubBucketCount / 2;
+    const unsigned MaxShift = 64 - SubBucketBits;
+}
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(SubBucketCount + MaxShift * HalfCount, 0)
+{
+}
+
+std::size_t LatencyHistogram::bucket(uint64_t micros) {
+    if (micros < SubBucketCount) return static_cast<std::size_t>(micros);
+
+    unsigned bits = 0;
+    for (uint64_t v = micros; v != 0; v >>= 1) ++bits;
+    unsigned shift = bits - SubBucketBits;
+    uint64_t sub = micros >> shift;
+    return static_cast<std::size_t>(SubBucketCount + (shift - 1) * HalfCount + (sub - HalfCount));
+}
+
+uint64_t LatencyHistogram::bucketValue(std::size_t index) {
+    if (index < SubBucketCount) return index;
+
+    unsigned shift = static_cast<unsigned>((index - SubBucketCount) / HalfCount) + 1;
+    uint64_t sub = (index - SubBucketCount) % HalfCount + HalfCount;
+    return (sub << shift) + ((1ULL << shift) >> 1);
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    ++counts_[bucket(micros)];
+    ++count_;
+    max_ = std::max(max_, micros);
+    sum_ += static_cast<double>(micros);
+}
+
+void LatencyHistogram::recordCorrected(uint64_t micros, uint64_t expectedInterval) {
+    record(micros);
+    if (expectedInterval == 0) return;
+
+    for (uint64_t missed = micros; missed >= 2 * expectedInterval; ) {
+        missed -= expectedInterval;
+        record(missed);
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (count_ == 0) return 0;
+
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(count_) + 0.5);
+    rank = std::min(std::max<uint64_t>(rank, 1), count_);
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) return std::min(bucketValue(i), max_);
+    }
+    return max_;
+}
+
+double LatencyHistogram::mean() const {
+    return count_ == 0 ? 0.0 : sum_ / static_cast<double>(count_);
+}
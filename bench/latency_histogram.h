@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+//       
+// (   1%),   HdrHistogram.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(uint64_t micros);
+    //  ,    ,    
+    void recordCorrected(uint64_t micros, uint64_t expectedInterval);
+    void merge(const LatencyHistogram& other);
+
+    uint64_t percentile(double p) const;
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    double mean() const;
+
+private:
+    static std::size_t bucket(uint64_t micros);
+    static uint64_t bucketValue(std::size_t index);
+
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    uint64_t max_ = 0;
+    double sum_ = 0;
+};
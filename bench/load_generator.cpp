@@ -0,0 +1,317 @@
+#include "load_generator.h"
+
+#include <boost/beast/core.hpp>
+#include <boost/asio.hpp>
+#include <fstream>
+#include <thread>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <cctype>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    const auto RequestTimeout = std::chrono::seconds(30);
+    const auto RetryDelay = std::chrono::milliseconds(100);
+    const auto FinishGrace = std::chrono::seconds(5);
+
+    std::string formEncode(const std::string& text) {
+        static const char hex[] = "0123456789ABCDEF";
+        std::string res;
+        for (unsigned char c : text) {
+            if (std::isalnum(c) || c == '-' || c == '_' || c == '.') res += static_cast<char>(c);
+            else if (c == ' ') res += '+';
+            else {
+                res += '%';
+                res += hex[c >> 4];
+                res += hex[c & 15];
+            }
+        }
+        return res;
+    }
+
+    uint64_t micros(Clock::duration d) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+    }
+
+    class Client;
+
+    //  :  io_context   ,   
+    struct Worker {
+        const LoadOptions& options;
+        const std::vector<BenchRequest>& log;
+        const tcp::resolver::results_type& endpoints;
+        Clock::time_point start;
+        Clock::time_point measureStart;
+        Clock::time_point end;
+
+        net::io_context ioc{ 1 };
+        net::steady_timer guard{ ioc };
+        std::vector<std::shared_ptr<Client>> clients;
+        std::size_t active = 0;
+        std::size_t cursor = 0;
+
+        LoadResult result;
+        LatencyHistogram warmup;
+        uint64_t expectedInterval = 0;
+        bool expectedReady = false;
+
+        void finished();
+    };
+
+    class Client : public std::enable_shared_from_this<Client> {
+    public:
+        Client(Worker& worker, std::size_t index)
+            : worker_(worker), stream_(worker.ioc), timer_(worker.ioc)
+        {
+            //       ,     
+            if (worker.options.rate > 0) {
+                double rate = worker.options.rate;
+                interval_ = std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(worker.options.connections / rate));
+                nextIntended_ = worker.start + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(index / rate));
+            }
+        }
+
+        void start() { scheduleNext(); }
+        void stop() { stream_.close(); timer_.cancel(); }
+
+    private:
+        bool openLoop() const { return worker_.options.rate > 0; }
+
+        void scheduleNext() {
+            auto now = Clock::now();
+            if (openLoop()) {
+                intended_ = nextIntended_;
+                nextIntended_ += interval_;
+            }
+            else {
+                intended_ = std::max(now, worker_.start);
+            }
+
+            if (intended_ >= worker_.end) {
+                worker_.finished();
+                return;
+            }
+
+            if (intended_ <= now) {
+                send();
+                return;
+            }
+
+            timer_.expires_at(intended_);
+            timer_.async_wait([self = shared_from_this()](beast::error_code ec) {
+                if (!ec) self->send();
+            });
+        }
+
+        void send() {
+            const BenchRequest& next = worker_.log[worker_.cursor++ % worker_.log.size()];
+            request_ = {};
+            request_.method(next.method);
+            request_.target(next.target);
+            request_.version(11);
+            request_.set(http::field::host, worker_.options.host);
+            request_.set(http::field::user_agent, "ServerLoadBench");
+            if (!next.contentType.empty()) request_.set(http::field::content_type, next.contentType);
+            request_.body() = next.body;
+            request_.keep_alive(true);
+            request_.prepare_payload();
+
+            //      
+            sent_ = Clock::now();
+            if (connected_) {
+                write();
+                return;
+            }
+
+            stream_.expires_after(RequestTimeout);
+            stream_.async_connect(worker_.endpoints,
+                [self = shared_from_this()](beast::error_code ec, const tcp::endpoint&) {
+                    if (ec) return self->fail();
+                    self->connected_ = true;
+                    self->write();
+                });
+        }
+
+        void write() {
+            stream_.expires_after(RequestTimeout);
+            http::async_write(stream_, request_,
+                [self = shared_from_this()](beast::error_code ec, std::size_t) {
+                    if (ec) return self->fail();
+                    self->response_ = {};
+                    http::async_read(self->stream_, self->buffer_, self->response_,
+                        [self](beast::error_code ec, std::size_t) {
+                            if (ec) return self->fail();
+                            self->onResponse();
+                        });
+                });
+        }
+
+        void onResponse() {
+            auto done = Clock::now();
+            uint64_t service = micros(done - sent_);
+
+            if (intended_ >= worker_.measureStart) {
+                LoadResult& result = worker_.result;
+                ++result.requests;
+                ++result.statuses[response_.result_int()];
+                result.service.record(service);
+
+                if (openLoop()) {
+                    result.response.record(micros(done - intended_));
+                }
+                else {
+                    //        
+                    if (!worker_.expectedReady) {
+                        worker_.expectedInterval = worker_.warmup.percentile(50);
+                        worker_.expectedReady = true;
+                    }
+                    result.response.recordCorrected(service, worker_.expectedInterval);
+                }
+            }
+            else if (!openLoop()) {
+                worker_.warmup.record(service);
+            }
+
+            if (!response_.keep_alive()) {
+                disconnect();
+                ++worker_.result.reconnects;
+            }
+            scheduleNext();
+        }
+
+        void fail() {
+            if (!worker_.ioc.stopped() && intended_ >= worker_.measureStart) ++worker_.result.errors;
+            disconnect();
+
+            timer_.expires_after(RetryDelay);
+            timer_.async_wait([self = shared_from_this()](beast::error_code ec) {
+                if (!ec) self->scheduleNext();
+            });
+        }
+
+        void disconnect() {
+            beast::error_code ec;
+            stream_.socket().shutdown(tcp::socket::shutdown_both, ec);
+            stream_.close();
+            buffer_.clear();
+            connected_ = false;
+        }
+
+        Worker& worker_;
+        beast::tcp_stream stream_;
+        net::steady_timer timer_;
+        beast::flat_buffer buffer_;
+        http::request<http::string_body> request_;
+        http::response<http::string_body> response_;
+        bool connected_ = false;
+
+        Clock::duration interval_{};
+        Clock::time_point nextIntended_;
+        Clock::time_point intended_;
+        Clock::time_point sent_;
+    };
+
+    void Worker::finished() {
+        if (--active == 0) guard.cancel();
+    }
+
+    void runWorker(Worker& worker) {
+        worker.active = worker.clients.size();
+
+        //       
+        worker.guard.expires_at(worker.end + FinishGrace);
+        worker.guard.async_wait([&worker](beast::error_code ec) {
+            if (ec) return;
+            for (auto& client : worker.clients) client->stop();
+            worker.ioc.stop();
+        });
+
+        for (auto& client : worker.clients) client->start();
+        worker.ioc.run();
+        worker.clients.clear();
+    }
+}
+
+std::vector<BenchRequest> loadQueryLog(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open query log: " + path);
+    }
+
+    std::vector<BenchRequest> log;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        BenchRequest request;
+        if (line.rfind("GET ", 0) == 0) {
+            request = { http::verb::get, line.substr(4), "", "" };
+        }
+        else if (line.rfind("POST ", 0) == 0) {
+            std::size_t space = line.find(' ', 5);
+            std::string body = space == std::string::npos ? "" : line.substr(space + 1);
+            std::string type = !body.empty() && body[0] == '{'
+                ? "application/json" : "application/x-www-form-urlencoded";
+            request = { http::verb::post, line.substr(5, space - 5), body, type };
+        }
+        else {
+            request = { http::verb::post, "/", "search=" + formEncode(line), "application/x-www-form-urlencoded" };
+        }
+        log.push_back(std::move(request));
+    }
+
+    if (log.empty()) {
+        throw std::runtime_error("Query log is empty: " + path);
+    }
+    return log;
+}
+
+LoadResult runLoad(const LoadOptions& options, const std::vector<BenchRequest>& log) {
+    net::io_context resolveContext;
+    tcp::resolver resolver(resolveContext);
+    auto endpoints = resolver.resolve(options.host, options.port);
+
+    std::size_t threads = std::max<std::size_t>(1, std::min(options.threads, options.connections));
+    auto start = Clock::now() + std::chrono::milliseconds(100);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker{
+            options, log, endpoints, start, start + options.warmup, start + options.warmup + options.duration }));
+        workers.back()->cursor = i * log.size() / threads;
+    }
+    for (std::size_t i = 0; i < options.connections; ++i) {
+        Worker& worker = *workers[i % threads];
+        worker.clients.push_back(std::make_shared<Client>(worker, i));
+    }
+
+    std::vector<std::thread> pool;
+    for (auto& worker : workers) {
+        pool.emplace_back(runWorker, std::ref(*worker));
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    LoadResult total;
+    for (auto& worker : workers) {
+        const LoadResult& result = worker->result;
+        total.service.merge(result.service);
+        total.response.merge(result.response);
+        total.requests += result.requests;
+        total.errors += result.errors;
+        total.reconnects += result.reconnects;
+        for (const auto& [status, count] : result.statuses) total.statuses[status] += count;
+    }
+    total.seconds = std::chrono::duration<double>(options.duration).count();
+    return total;
+}
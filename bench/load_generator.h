@@ -0,0 +1,44 @@
+#pragma once
+#include <boost/beast/http.hpp>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdint>
+#include "latency_histogram.h"
+
+struct BenchRequest {
+    boost::beast::http::verb method;
+    std::string target;
+    std::string body;
+    std::string contentType;
+};
+
+//  : "GET <target>", "POST <target> <body>"    
+std::vector<BenchRequest> loadQueryLog(const std::string& path);
+
+struct LoadOptions {
+    std::string host;
+    std::string port;
+    std::size_t connections;
+    std::size_t threads;
+    double rate;                        //   , 0 -  
+    std::chrono::seconds warmup;
+    std::chrono::seconds duration;
+};
+
+struct LoadResult {
+    LatencyHistogram service;           //     
+    LatencyHistogram response;          //    coordinated omission
+    uint64_t requests = 0;
+    uint64_t errors = 0;
+    uint64_t reconnects = 0;
+    std::map<unsigned, uint64_t> statuses;
+    double seconds = 0;
+};
+
+//      keep-alive .
+//  :        .
+//  :       ,  
+//    ,     .
+LoadResult runLoad(const LoadOptions& options, const std::vector<BenchRequest>& log);
@@ -0,0 +1,175 @@
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <boost/locale.hpp>
+#include "config_parser.h"
+#include "database.h"
+#include "fixture.h"
+#include "load_generator.h"
+
+//  [bench]  config.ini,     --key=value
+class BenchSettings {
+public:
+    BenchSettings(const ConfigParser& config, int argc, char* argv[]) : config_(config) {
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            std::size_t eq = arg.find('=');
+            if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+                throw std::runtime_error("Invalid argument: " + arg);
+            }
+            overrides_[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+        }
+    }
+
+    std::string get(const std::string& key) const {
+        auto it = overrides_.find(key);
+        return it != overrides_.end() ? it->second : config_.get("bench", key);
+    }
+    int getInt(const std::string& key) const { return std::stoi(get(key)); }
+
+private:
+    const ConfigParser& config_;
+    std::map<std::string, std::string> overrides_;
+};
+
+void printHistogram(const char* name, const LatencyHistogram& histogram) {
+    std::cout << std::left << std::setw(10) << name << std::right
+        << " p50 " << std::setw(9) << histogram.percentile(50)
+        << "  p99 " << std::setw(9) << histogram.percentile(99)
+        << "  p999 " << std::setw(9) << histogram.percentile(99.9)
+        << "  max " << std::setw(9) << histogram.max()
+        << "  mean " << std::fixed << std::setprecision(0) << histogram.mean() << " us\n";
+}
+
+//       [bench] dbname,    :
+//         
+Database openBenchDatabase(const ConfigParser& config, const BenchSettings& settings,
+    const std::string& searchBackend) {
+    std::string dbname = settings.get("dbname");
+    if (dbname == config.get("database", "dbname")) {
+        throw std::runtime_error("[bench] dbname must differ from [database] dbname");
+    }
+
+    return Database(
+        config.get("database", "host"),
+        config.get("database", "port"),
+        dbname,
+        config.get("database", "user"),
+        config.get("database", "password"),
+        searchBackend
+    );
+}
+
+void runSeed(const ConfigParser& config, const BenchSettings& settings) {
+    Database db = openBenchDatabase(config, settings, config.get("database", "search_backend"));
+    db.initializeSchema();
+
+    BenchFixture fixture(settings.getInt("seed"), settings.getInt("vocabulary"));
+    fixture.seedDatabase(db, settings.getInt("documents"), settings.getInt("words_per_document"),
+        "http://bench.local/doc/");
+    fixture.writeQueryLog(settings.get("query_log"), settings.getInt("queries"));
+
+    std::cout << "Query log written to " << settings.get("query_log") << std::endl;
+}
+
+//         .       
+// document_words,        http://bench.local/,
+//    seed:        
+void runBackends(const ConfigParser& config, const BenchSettings& settings) {
+    std::size_t documents = settings.getInt("documents");
+    std::size_t queries = settings.getInt("queries");
+
+    for (const char* backend : { "words", "tsvector" }) {
+        Database db = openBenchDatabase(config, settings, backend);
+        db.initializeSchema();
+
+        std::string urlPrefix = std::string("http://bench.local/") + backend + "/doc/";
+        db.removeDocuments("http://bench.local/");
+
+        BenchFixture fixture(settings.getInt("seed"), settings.getInt("vocabulary"));
+        long long sizeBefore = db.searchIndexSize();
+        auto started = std::chrono::steady_clock::now();
+        fixture.seedDatabase(db, documents, settings.getInt("words_per_document"), urlPrefix);
+        double ingestSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        long long sizeAfter = db.searchIndexSize();
+
+        LatencyHistogram latency;
+        std::size_t found = 0;
+        for (auto& words : fixture.searchQueries(queries)) {
+            auto queryStarted = std::chrono::steady_clock::now();
+            auto results = db.searchBatch({ { std::move(words), 10, 0 } });
+            latency.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - queryStarted).count());
+            found += results.front().size();
+        }
+
+        std::cout << "Backend " << backend << ": index " << (sizeAfter - sizeBefore) / 1024 << " KB"
+            << ", ingest " << std::fixed << std::setprecision(1) << documents / ingestSeconds << " docs/s"
+            << ", " << queries << " queries, " << found << " results\n";
+        printHistogram("Query", latency);
+    }
+
+    std::cout << "Seeded bench documents were removed, run 'seed' again before 'run'\n";
+}
+
+void runBench(const ConfigParser& config, const BenchSettings& settings) {
+    LoadOptions options{
+        settings.get("host"),
+        std::to_string(config.getInt("server", "port")),
+        static_cast<std::size_t>(settings.getInt("connections")),
+        static_cast<std::size_t>(settings.getInt("threads")),
+        std::stod(settings.get("rate")),
+        std::chrono::seconds(settings.getInt("warmup")),
+        std::chrono::seconds(settings.getInt("duration"))
+    };
+    if (options.connections == 0) {
+        throw std::runtime_error("At least one connection is required");
+    }
+
+    auto log = loadQueryLog(settings.get("query_log"));
+
+    std::cout << (options.rate > 0 ? "Open loop at " + settings.get("rate") + " req/s" : std::string("Closed loop"))
+        << ", " << options.connections << " connections, " << log.size() << " logged requests, "
+        << options.warmup.count() << "s warmup + " << options.duration.count() << "s" << std::endl;
+
+    LoadResult result = runLoad(options, log);
+
+    std::cout << "Requests:   " << result.requests << " (" << std::fixed << std::setprecision(1)
+        << result.requests / result.seconds << " req/s)\n";
+    std::cout << "Errors:     " << result.errors << "\n";
+    std::cout << "Reconnects: " << result.reconnects << "\n";
+    for (const auto& [status, count] : result.statuses) {
+        std::cout << "HTTP " << status << ":   " << count << "\n";
+    }
+    printHistogram("Service", result.service);
+    printHistogram("Corrected", result.response);
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        std::locale::global(boost::locale::generator().generate("en_US.UTF-8"));
+
+        ConfigParser config("config.ini");
+        std::string mode = argc > 1 ? argv[1] : "run";
+        BenchSettings settings(config, argc, argv);
+
+        if (mode == "seed") {
+            runSeed(config, settings);
+        }
+        else if (mode == "run") {
+            runBench(config, settings);
+        }
+        else if (mode == "backends") {
+            runBackends(config, settings);
+        }
+        else {
+            std::cerr << "Usage: ServerLoadBench seed|run|backends [--key=value ...]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Bench error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -5,10 +5,20 @@
 #include <locale>
 #include <codecvt>
 #include <iostream>
-
+#include <regex>
+#include <boost/algorithm/string.hpp>
+#include <boost/locale.hpp>
+#include <boost/json.hpp>
+#include "static_page.h"
+#include "page_template.h"
+
+using namespace std;
 namespace beast = boost::beast;
 namespace http = beast::http;
 namespace net = boost::asio;
+namespace ba = boost::algorithm;
+namespace bl = boost::locale;
+namespace json = boost::json;
 using tcp = boost::asio::ip::tcp;
 
 
@@ -37,14 +47,113 @@ std::string convert_to_utf8(const std::string& str) {
 	return url_decoded;
 }
 
-HttpConnection::HttpConnection(tcp::socket socket)
-	: socket_(std::move(socket))
-{
+void json_escape(std::string& res, beast::string_view str) {
+	for (char ch : str) {
+		switch (ch) {
+		case '"': res += "\\\""; break;
+		case '\\': res += "\\\\"; break;
+		case '\n': res += "\\n"; break;
+		case '\r': res += "\\r"; break;
+		case '\t': res += "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(ch) < 0x20) {
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04x", ch);
+				res += buf;
+			}
+			else {
+				res += ch;
+			}
+		}
+	}
 }
 
+vector<string> split_query(string& query) {
+	//  
+	static const regex punct_regex("[^\\w\\s]");
+	query = regex_replace(query, punct_regex, " ");
+	query = bl::to_lower(query);
+
+	//   
+	vector<string> words;
+	ba::split(words, query, ba::is_any_of(" "), ba::token_compress_on);
+	words.erase(remove_if(words.begin(), words.end(),
+		[](const string& s) { return s.length() < 3 || s.length() > 32; }),
+		words.end());
+
+	//         
+	sort(words.begin(), words.end());
+	words.erase(unique(words.begin(), words.end()), words.end());
+
+	return words;
+}
+
+
+namespace {
+	//          
+	const StaticPage homePage(
+		"<html>\n"
+		"<head><meta charset=\"UTF-8\"><title>Search Engine</title></head>\n"
+		"<body>\n"
+		"<h1>Search Engine</h1>\n"
+		"<p>Welcome!<p>\n"
+		"<form action=\"/\" method=\"post\">\n"
+		"    <label for=\"search\">Search:</label><br>\n"
+		"    <input type=\"text\" id=\"search\" name=\"search\"><br>\n"
+		"    <input type=\"submit\" value=\"Search\">\n"
+		"</form>\n"
+		"</body>\n"
+		"</html>\n",
+		"text/html");
+
+	const PageTemplate resultsPage(
+		"<html><head><meta charset='UTF-8'><title>Results</title></head><body>"
+		"<h1>Results for \"{{query}}\"</h1>{{{results}}}</body></html>",
+		{ "query", "results" });
+
+	const PageTemplate resultItem(
+		"<li><a href=\"{{url}}\">{{title}}</a> (relevance: {{score}})<br>{{{snippet}}}</li>",
+		{ "url", "title", "score", "snippet" });
+
+	//    
+	const size_t snippetTokens = 30;
+
+	//      
+	void appendSnippetHtml(string& out, const Snippet& snippet) {
+		boost::string_view text(snippet.text);
+		size_t pos = 0;
+		if (snippet.cutBefore) out += "... ";
+		for (const auto& [start, length] : snippet.highlights) {
+			appendHtmlEscaped(out, text.substr(pos, start - pos));
+			out += "<b>";
+			appendHtmlEscaped(out, text.substr(start, length));
+			out += "</b>";
+			pos = start + length;
+		}
+		appendHtmlEscaped(out, text.substr(pos));
+		if (snippet.cutAfter) out += " ...";
+	}
+}
+
+
+void HttpConnection::reset(tcp::socket socket)
+{
+	socket_ = std::move(socket);
+
+	//     
+	buffer_.consume(buffer_.size());
+	std::string requestBody = std::move(request_.body());
+	requestBody.clear();
+	request_ = {};
+	request_.body() = std::move(requestBody);
+
+	static_ = nullptr;
+	body_.clear();
+}
 
 void HttpConnection::start()
 {
+	deadline_.expires_after(std::chrono::seconds(60));
 	readRequest();
 	checkDeadline();
 }
@@ -69,86 +178,104 @@ void HttpConnection::readRequest()
 
 void HttpConnection::processRequest()
 {
-	response_.version(request_.version());
-	response_.keep_alive(false);
-
 	switch (request_.method())
 	{
 	case http::verb::get:
-		response_.result(http::status::ok);
-		response_.set(http::field::server, "Beast");
+		setResponse(http::status::ok, "text/html");
 		createResponseGet();
 		break;
 	case http::verb::post:
-		response_.result(http::status::ok);
-		response_.set(http::field::server, "Beast");
+		setResponse(http::status::ok, "text/html");
 		createResponsePost();
 		break;
 
 	default:
-		response_.result(http::status::bad_request);
-		response_.set(http::field::content_type, "text/plain");
-		beast::ostream(response_.body())
-			<< "Invalid request-method '"
-			<< std::string(request_.method_string())
-			<< "'";
+		setResponse(http::status::bad_request, "text/plain");
+		body_ += "Invalid request-method '";
+		body_.append(request_.method_string().data(), request_.method_string().size());
+		body_ += "'";
 		break;
 	}
 
 	writeResponse();
 }
 
+void HttpConnection::setResponse(http::status status, const char* contentType)
+{
+	status_ = status;
+	contentType_ = contentType;
+	body_.clear();
+}
+
 
 void HttpConnection::createResponseGet()
 {
 	if (request_.target() == "/")
 	{
-		response_.set(http::field::content_type, "text/html");
-		beast::ostream(response_.body())
-			<< "<html>\n"
-			<< "<head><meta charset=\"UTF-8\"><title>Search Engine</title></head>\n"
-			<< "<body>\n"
-			<< "<h1>Search Engine</h1>\n"
-			<< "<p>Welcome!<p>\n"
-			<< "<form action=\"/\" method=\"post\">\n"
-			<< "    <label for=\"search\">Search:</label><br>\n"
-			<< "    <input type=\"text\" id=\"search\" name=\"search\"><br>\n"
-			<< "    <input type=\"submit\" value=\"Search\">\n"
-			<< "</form>\n"
-			<< "</body>\n"
-			<< "</html>\n";
+		static_ = &homePage.select(request_);
+	}
+	else if (request_.target().substr(0, request_.target().find('?')) == "/suggest")
+	{
+		createResponseSuggest();
 	}
 	else
 	{
-		response_.result(http::status::not_found);
-		response_.set(http::field::content_type, "text/plain");
-		beast::ostream(response_.body()) << "File not found\r\n";
+		setResponse(http::status::not_found, "text/plain");
+		body_ += "File not found\r\n";
+	}
+}
+
+void HttpConnection::createResponseSuggest()
+{
+	static const regex query_regex("[?&]q=([^&]*)");
+	static const regex limit_regex("[?&]k=([0-9]{1,9})(&|$)");
+	string target(request_.target());
+	smatch match;
+	string prefix;
+
+	if (regex_search(target, match, query_regex)) {
+		prefix = bl::to_lower(url_decode(match[1].str()));
+	}
+
+	//    ,      .
+	//    suggest_top_k ,  k=     
+	vector<pair<string, int>> suggestions;
+	auto index = suggester_.snapshot();
+	if (index && !prefix.empty()) {
+		size_t limit = index->topK();
+		if (regex_search(target, match, limit_regex)) {
+			limit = min<size_t>(limit, stoul(match[1].str()));
+		}
+		suggestions = index->complete(prefix, limit);
+	}
+
+	setResponse(http::status::ok, "application/json; charset=utf-8");
+	body_ += "[";
+	for (size_t i = 0; i < suggestions.size(); ++i) {
+		if (i != 0) body_ += ",";
+		body_ += "{\"word\":\"";
+		json_escape(body_, suggestions[i].first);
+		body_ += "\",\"documents\":";
+		body_ += to_string(suggestions[i].second);
+		body_ += "}";
 	}
+	body_ += "]";
 }
 
 void HttpConnection::createResponsePost()
 {
 	if (request_.target() == "/") {
-		string body = buffers_to_string(request_.body().data());
+		static const regex search_regex("search=([^&]*)");
+		const string& body = request_.body();
 		smatch match;
 
-		if (!regex_search(body, match, regex("search=([^&]*)"))) {
+		if (!regex_search(body, match, search_regex)) {
 			sendError(http::status::bad_request, "Invalid search request");
 			return;
 		}
 
 		string query = url_decode(match[1].str());
-
-		//  
-		query = regex_replace(query, regex("[^\\w\\s]"), " ");
-		query = bl::to_lower(query);
-
-		//   
-		vector<string> words;
-		ba::split(words, query, ba::is_any_of(" "), ba::token_compress_on);
-		words.erase(remove_if(words.begin(), words.end(),
-			[](const string& s) { return s.length() < 3 || s.length() > 32; }),
-			words.end());
+		vector<string> words = split_query(query);
 
 		if (words.empty()) {
 			sendError(http::status::bad_request, "Query too short");
@@ -159,44 +286,209 @@ void HttpConnection::createResponsePost()
 		try {
 			auto results = db_.search(words);
 
-			response_.set(http::field::content_type, "text/html; charset=utf-8");
-			beast::ostream(response_.body())
-				<< "<html><head><meta charset='UTF-8'><title>Results</title></head><body>"
-				<< "<h1>Results for \"" << query << "\"</h1>";
-
+			//       ,    
+			scratch_.clear();
 			if (results.empty()) {
-				response_.body() << "<p>No results found</p>";
+				scratch_ += "<p>No results found</p>";
 			}
 			else {
-				response_.body() << "<ol>";
-				for (const auto& [url, title, score] : results) {
-					response_.body()
-						<< "<li><a href=\"" << url << "\">" << title
-						<< "</a> (relevance: " << score << ")</li>";
+				scratch_ += "<ol>";
+				for (const auto& [url, title, score, snippetData] : results) {
+					char relevance[16];
+					int length = snprintf(relevance, sizeof(relevance), "%d", score);
+					snippetHtml_.clear();
+					if (makeSnippet(snippetData, words, snippetTokens, snippet_)) {
+						appendSnippetHtml(snippetHtml_, snippet_);
+					}
+					resultItem.render(scratch_, { url, title, boost::string_view(relevance, length), snippetHtml_ });
 				}
-				response_.body() << "</ol>";
+				scratch_ += "</ol>";
 			}
 
-			response_.body() << "</body></html>";
+			setResponse(http::status::ok, "text/html; charset=utf-8");
+			resultsPage.render(body_, { query, scratch_ });
 		}
 		catch (const exception& e) {
 			sendError(http::status::internal_server_error, "Database error: " + string(e.what()));
 		}
 	}
+	else if (request_.target() == "/api/search") {
+		createResponseApiSearch();
+	}
 	else {
 		sendError(http::status::not_found, "Page not found");
 	}
 }
 
+void HttpConnection::createResponseApiSearch()
+{
+	const size_t maxBatch = 100;
+	const int maxLimit = 100;
+	const int maxOffset = 10000;
+
+	auto fail = [this](http::status status, const string& message) {
+		setResponse(status, "application/json; charset=utf-8");
+		body_ += "{\"error\":\"";
+		json_escape(body_, message);
+		body_ += "\"}";
+	};
+
+	boost::system::error_code ec;
+	json::value request = json::parse(request_.body(), ec);
+	if (ec || !request.is_object()) {
+		fail(http::status::bad_request, "Invalid JSON");
+		return;
+	}
+
+	//        
+	const json::object& root = request.get_object();
+	bool batch = root.contains("queries");
+	vector<const json::value*> items;
+
+	if (batch) {
+		const json::array* array = root.at("queries").if_array();
+		if (!array || array->empty() || array->size() > maxBatch) {
+			fail(http::status::bad_request, "Field 'queries' must be an array of 1.."
+				+ to_string(maxBatch) + " queries");
+			return;
+		}
+		for (const auto& item : *array) items.push_back(&item);
+	}
+	else {
+		items.push_back(&request);
+	}
+
+	vector<string> texts;
+	vector<SearchQuery> queries;
+	for (const json::value* item : items) {
+		const json::object* object = item->if_object();
+		const json::value* text = object ? object->if_contains("query") : nullptr;
+		if (!text || !text->is_string()) {
+			fail(http::status::bad_request, "Field 'query' must be a string");
+			return;
+		}
+
+		SearchQuery query{ {}, 10, 0 };
+		for (auto [key, field] : { make_pair("limit", &query.limit), make_pair("offset", &query.offset) }) {
+			const json::value* value = object->if_contains(key);
+			if (!value) continue;
+			if (!value->is_int64() || value->get_int64() < 0) {
+				fail(http::status::bad_request, "Field '" + string(key) + "' must be a non-negative integer");
+				return;
+			}
+			*field = static_cast<int>(min<int64_t>(value->get_int64(), INT32_MAX));
+		}
+		query.limit = min(query.limit, maxLimit);
+
+		//  offset + limit   SQL  int4;  offset    
+		if (query.offset > maxOffset) {
+			fail(http::status::bad_request, "Field 'offset' must be at most " + to_string(maxOffset));
+			return;
+		}
+
+		//     , split_query  
+		texts.emplace_back(text->get_string().c_str());
+		string cleaned = texts.back();
+		query.words = split_query(cleaned);
+		queries.push_back(move(query));
+	}
+
+	if (!batch && queries.front().words.empty()) {
+		fail(http::status::bad_request, "Query too short");
+		return;
+	}
+
+	//       
+	vector<vector<SearchHit>> results;
+	try {
+		results = db_.searchBatch(queries);
+	}
+	catch (const exception& e) {
+		fail(http::status::internal_server_error, "Database error: " + string(e.what()));
+		return;
+	}
+
+	//      ,    JSON
+	setResponse(http::status::ok, "application/json; charset=utf-8");
+	if (batch) body_ += "{\"results\":[";
+
+	for (size_t q = 0; q < queries.size(); ++q) {
+		if (q != 0) body_ += ",";
+		body_ += "{\"query\":\"";
+		json_escape(body_, texts[q]);
+		body_ += "\",\"limit\":";
+		body_ += to_string(queries[q].limit);
+		body_ += ",\"offset\":";
+		body_ += to_string(queries[q].offset);
+		body_ += ",\"results\":[";
+
+		for (size_t i = 0; i < results[q].size(); ++i) {
+			const auto& [url, title, score, snippetData] = results[q][i];
+			if (i != 0) body_ += ",";
+			body_ += "{\"url\":\"";
+			json_escape(body_, url);
+			body_ += "\",\"title\":\"";
+			json_escape(body_, title);
+			body_ += "\",\"relevance\":";
+			body_ += to_string(score);
+
+			//    :      UTF-8
+			if (makeSnippet(snippetData, queries[q].words, snippetTokens, snippet_)) {
+				body_ += ",\"snippet\":\"";
+				json_escape(body_, snippet_.text);
+				body_ += "\",\"highlights\":[";
+				for (size_t h = 0; h < snippet_.highlights.size(); ++h) {
+					if (h != 0) body_ += ",";
+					body_ += "[";
+					body_ += to_string(snippet_.highlights[h].first);
+					body_ += ",";
+					body_ += to_string(snippet_.highlights[h].second);
+					body_ += "]";
+				}
+				body_ += "]";
+			}
+			body_ += "}";
+		}
+		body_ += "]}";
+	}
+
+	if (batch) body_ += "]}";
+}
+
+void HttpConnection::sendError(http::status status, const std::string& message)
+{
+	setResponse(status, "text/plain");
+	body_ += message;
+	body_ += "\r\n";
+}
+
 void HttpConnection::writeResponse()
 {
 	auto self = shared_from_this();
+	std::array<net::const_buffer, 2> buffers;
 
-	response_.content_length(response_.body().size());
+	if (static_) {
+		//      
+		buffers = { net::buffer(*static_), net::const_buffer() };
+	}
+	else {
+		auto reason = http::obsolete_reason(status_);
+		head_.clear();
+		head_ += "HTTP/1.1 ";
+		head_ += to_string(static_cast<unsigned>(status_));
+		head_ += " ";
+		head_.append(reason.data(), reason.size());
+		head_ += "\r\nServer: Beast\r\nContent-Type: ";
+		head_ += contentType_;
+		head_ += "\r\nContent-Length: ";
+		head_ += to_string(body_.size());
+		head_ += "\r\nConnection: close\r\n\r\n";
+		buffers = { net::buffer(head_), net::buffer(body_) };
+	}
 
-	http::async_write(
+	net::async_write(
 		socket_,
-		response_,
+		buffers,
 		[self](beast::error_code ec, std::size_t)
 		{
 			self->socket_.shutdown(tcp::socket::shutdown_send, ec);
@@ -204,6 +496,13 @@ void HttpConnection::writeResponse()
 		});
 }
 
+void HttpConnection::close()
+{
+	beast::error_code ec;
+	socket_.close(ec);
+	deadline_.cancel();
+}
+
 void HttpConnection::checkDeadline()
 {
 	auto self = shared_from_this();
@@ -217,3 +516,57 @@ void HttpConnection::checkDeadline()
 			}
 		});
 }
+
+
+ConnectionPool::ConnectionPool(Database& db, Suggester& suggester, size_t capacity)
+	: db_(db), suggester_(suggester), capacity_(capacity)
+{
+	free_.reserve(capacity_);
+	blocks_.reserve(capacity_);
+}
+
+ConnectionPool::~ConnectionPool()
+{
+	//         
+	free_.clear();
+	for (void* block : blocks_) {
+		::operator delete(block);
+	}
+}
+
+std::shared_ptr<HttpConnection> ConnectionPool::acquire(tcp::socket socket)
+{
+	std::unique_ptr<HttpConnection> connection;
+	if (free_.empty()) {
+		connection = std::make_unique<HttpConnection>(std::move(socket), db_, suggester_);
+	}
+	else {
+		connection = std::move(free_.back());
+		free_.pop_back();
+		connection->reset(std::move(socket));
+	}
+
+	//     (  ),    
+	return std::shared_ptr<HttpConnection>(connection.release(),
+		[this](HttpConnection* released) { release(released); },
+		BlockAllocator<HttpConnection>(&blocks_));
+}
+
+void ConnectionPool::drain()
+{
+	draining_ = true;
+	free_.clear();
+}
+
+void ConnectionPool::release(HttpConnection* connection)
+{
+	//   :       
+	connection->close();
+
+	if (!draining_ && free_.size() < capacity_) {
+		free_.emplace_back(connection);
+	}
+	else {
+		delete connection;
+	}
+}
@@ -4,6 +4,11 @@
 #include <boost/beast/http.hpp>
 #include <boost/beast/version.hpp>
 #include <boost/asio.hpp>
+#include <memory>
+#include <vector>
+#include "database.h"
+#include "suggest_index.h"
+#include "snippet_text.h"
 
 namespace beast = boost::beast;
 namespace http = beast::http;
@@ -14,6 +19,7 @@ class HttpConnection : public std::enable_shared_from_this<HttpConnection>
 {
 private:
 	Database& db_;
+	Suggester& suggester_;
 
 protected:
 
@@ -21,24 +27,102 @@ protected:
 
 	beast::flat_buffer buffer_{ 8192 };
 
-	http::request<http::dynamic_body> request_;
-
-	http::response<http::dynamic_body> response_;
+	http::request<http::string_body> request_;
 
+	http::status status_ = http::status::ok;
+	const char* contentType_ = "text/html";
+	const std::string* static_ = nullptr;
+	std::string head_;
+	std::string body_;
+	std::string scratch_;
+	std::string snippetHtml_;
+	Snippet snippet_;
 
 	net::steady_timer deadline_{
 		socket_.get_executor(), std::chrono::seconds(60) };
 
 	void readRequest();
 	void processRequest();
+	void setResponse(http::status status, const char* contentType);
 
 	void createResponseGet();
 
+	void createResponseSuggest();
+
 	void createResponsePost();
+	void createResponseApiSearch();
+	void sendError(http::status status, const std::string& message);
 	void writeResponse();
 	void checkDeadline();
 
 public:
-	HttpConnection(tcp::socket socket, Database& db) : socket_(std::move(socket)), db_(db) {};
+	HttpConnection(tcp::socket socket, Database& db, Suggester& suggester)
+		: db_(db), suggester_(suggester), socket_(std::move(socket)) {};
+	void reset(tcp::socket socket);
 	void start();
+	void close();
+};
+
+//  :       .
+//    io_context,   .
+class ConnectionPool
+{
+public:
+	ConnectionPool(Database& db, Suggester& suggester, std::size_t capacity);
+	~ConnectionPool();
+	std::shared_ptr<HttpConnection> acquire(tcp::socket socket);
+
+	//      io_context,   
+	//    ,     - ,  
+	void drain();
+
+	//  drain     ;   io_context
+	struct DrainGuard {
+		ConnectionPool& pool;
+		~DrainGuard() { pool.drain(); }
+	};
+
+private:
+	//    shared_ptr:  
+	//       
+	template <class T>
+	struct BlockAllocator {
+		using value_type = T;
+
+		std::vector<void*>* blocks;
+
+		explicit BlockAllocator(std::vector<void*>* blocks) : blocks(blocks) {}
+		template <class U>
+		BlockAllocator(const BlockAllocator<U>& other) : blocks(other.blocks) {}
+
+		T* allocate(std::size_t n) {
+			if (n == 1 && !blocks->empty()) {
+				void* block = blocks->back();
+				blocks->pop_back();
+				return static_cast<T*>(block);
+			}
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+
+		void deallocate(T* p, std::size_t n) {
+			if (n == 1) blocks->push_back(p);
+			else ::operator delete(p);
+		}
+
+		template <class U>
+		bool operator==(const BlockAllocator<U>& other) const { return blocks == other.blocks; }
+		template <class U>
+		bool operator!=(const BlockAllocator<U>& other) const { return blocks != other.blocks; }
+	};
+
+	void release(HttpConnection* connection);
+
+	Database& db_;
+	Suggester& suggester_;
+	std::size_t capacity_;
+	bool draining_ = false;
+
+	// blocks_   free_:       
+	std::vector<void*> blocks_;
+	std::vector<std::unique_ptr<HttpConnection>> free_;
 };
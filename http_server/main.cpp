@@ -1,27 +1,61 @@
 #include <iostream>
 #include <chrono>
+#include <thread>
 #include <Windows.h>
+#include <boost/locale.hpp>
 #include "http_connection.h"
 #include "database.h"
 #include "config_parser.h"
 #include "search_handler.h"
+#include "suggest_index.h"
 
-void runServer(tcp::acceptor& acceptor, tcp::socket& socket, Database& db) {
+void runServer(tcp::acceptor& acceptor, tcp::socket& socket, ConnectionPool& pool) {
     acceptor.async_accept(socket,
         [&](beast::error_code ec) {
             if (!ec) {
-                std::make_shared<HttpConnection>(std::move(socket), db)->start();
+                pool.acquire(std::move(socket))->start();
             }
-            runServer(acceptor, socket, db);
+            runServer(acceptor, socket, pool);
         });
 }
 
+void rebuildSuggestions(ConfigParser config, Suggester& suggester, std::size_t topK, int interval) {
+    //  :      .
+    //   ( Postgres,  )   
+    std::unique_ptr<Database> db;
+
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::seconds(interval));
+
+        try {
+            if (!db) {
+                db = std::make_unique<Database>(
+                    config.get("database", "host"),
+                    config.get("database", "port"),
+                    config.get("database", "dbname"),
+                    config.get("database", "user"),
+                    config.get("database", "password"),
+                    config.get("database", "search_backend")
+                );
+            }
+            suggester.update(std::make_shared<SuggestIndex>(db->wordFrequencies(), topK));
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Suggest rebuild error: " << e.what() << std::endl;
+            db.reset();
+        }
+    }
+}
+
 int main(int argc, char* argv[]) {
     try {
         //    Windows
         SetConsoleCP(CP_UTF8);
         SetConsoleOutputCP(CP_UTF8);
 
+        //   boost::locale (to_lower, normalize)
+        std::locale::global(boost::locale::generator().generate("en_US.UTF-8"));
+
         //  
         ConfigParser config("config.ini");
 
@@ -31,19 +65,31 @@ int main(int argc, char* argv[]) {
             config.get("database", "port"),
             config.get("database", "dbname"),
             config.get("database", "user"),
-            config.get("database", "password")
+            config.get("database", "password"),
+            config.get("database", "search_backend")
         );
 
+        //  
+        Suggester suggester;
+        std::size_t suggestTopK = config.getInt("server", "suggest_top_k");
+        int suggestInterval = config.getInt("server", "suggest_rebuild_interval");
+        suggester.update(std::make_shared<SuggestIndex>(db.wordFrequencies(), suggestTopK));
+        std::thread(rebuildSuggestions, config, std::ref(suggester), suggestTopK, suggestInterval).detach();
+
+        //    io_context:      
+        ConnectionPool pool(db, suggester, config.getInt("server", "connection_pool_size"));
+
         //  
         auto const address = net::ip::make_address("0.0.0.0");
         unsigned short port = config.getInt("server", "port");
 
         net::io_context ioc{ 1 };
+        ConnectionPool::DrainGuard drainPool{ pool };
         tcp::acceptor acceptor{ ioc, {address, port} };
         tcp::socket socket{ ioc };
 
         //  
-        runServer(acceptor, socket, db);
+        runServer(acceptor, socket, pool);
 
         std::cout << "Search server started on http://localhost:" << port << std::endl;
         std::cout << "Press Ctrl+C to stop..." << std::endl;
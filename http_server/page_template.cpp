@@ -0,0 +1,58 @@
+#include "page_template.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+PageTemplate::PageTemplate(const std::string& source, std::initializer_list<const char*> names) {
+	std::vector<std::string> slots(names.begin(), names.end());
+	size_t pos = 0;
+
+	while (true) {
+		size_t open = source.find("{{", pos);
+		if (open == std::string::npos) {
+			parts_.push_back({ source.substr(pos), -1, false });
+			break;
+		}
+
+		bool raw = source.compare(open, 3, "{{{") == 0;
+		size_t nameStart = open + (raw ? 3 : 2);
+		size_t close = source.find(raw ? "}}}" : "}}", nameStart);
+		if (close == std::string::npos) {
+			throw std::runtime_error("Unterminated template placeholder");
+		}
+
+		std::string name = source.substr(nameStart, close - nameStart);
+		auto slot = std::find(slots.begin(), slots.end(), name);
+		if (slot == slots.end()) {
+			throw std::runtime_error("Unknown template placeholder: " + name);
+		}
+
+		parts_.push_back({ source.substr(pos, open - pos), static_cast<int>(slot - slots.begin()), raw });
+		pos = close + (raw ? 3 : 2);
+	}
+}
+
+void PageTemplate::render(std::string& out, std::initializer_list<boost::string_view> values) const {
+	const boost::string_view* value = values.begin();
+
+	for (const auto& part : parts_) {
+		out += part.literal;
+		if (part.slot < 0 || part.slot >= static_cast<int>(values.size())) continue;
+
+		if (part.raw) out.append(value[part.slot].data(), value[part.slot].size());
+		else appendHtmlEscaped(out, value[part.slot]);
+	}
+}
+
+void appendHtmlEscaped(std::string& out, boost::string_view text) {
+	for (char ch : text) {
+		switch (ch) {
+		case '&': out += "&amp;"; break;
+		case '<': out += "&lt;"; break;
+		case '>': out += "&gt;"; break;
+		case '"': out += "&quot;"; break;
+		case '\'': out += "&#39;"; break;
+		default: out += ch;
+		}
+	}
+}
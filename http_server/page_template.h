@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <initializer_list>
+#include <boost/utility/string_view.hpp>
+
+// ,     : {{name}} 
+//   HTML, {{{name}}} -  .  
+//     ,     .
+class PageTemplate {
+public:
+	PageTemplate(const std::string& source, std::initializer_list<const char*> names);
+
+	void render(std::string& out, std::initializer_list<boost::string_view> values) const;
+
+private:
+	struct Part {
+		std::string literal;
+		int slot;
+		bool raw;
+	};
+
+	std::vector<Part> parts_;
+};
+
+void appendHtmlEscaped(std::string& out, boost::string_view text);
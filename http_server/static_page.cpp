@@ -0,0 +1,102 @@
+#include "static_page.h"
+
+#include <array>
+#include <sstream>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <boost/beast/zlib/deflate_stream.hpp>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace zlib = boost::beast::zlib;
+
+namespace {
+	uint32_t crc32(const std::string& data) {
+		static const auto table = [] {
+			std::array<uint32_t, 256> t{};
+			for (uint32_t i = 0; i < 256; ++i) {
+				uint32_t c = i;
+				for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				t[i] = c;
+			}
+			return t;
+		}();
+
+		uint32_t crc = 0xFFFFFFFFu;
+		for (unsigned char ch : data) crc = table[(crc ^ ch) & 0xFF] ^ (crc >> 8);
+		return crc ^ 0xFFFFFFFFu;
+	}
+
+	// Beast   "" deflate,    gzip  
+	std::string gzip(const std::string& data) {
+		zlib::deflate_stream ds;
+		ds.reset(9, 15, 8, zlib::Strategy::normal);
+
+		const unsigned char header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 2, 0xff };
+		std::string out(reinterpret_cast<const char*>(header), 10);
+
+		std::string deflated(ds.upper_bound(data.size()) + 16, '\0');
+		zlib::z_params zs;
+		zs.next_in = data.data();
+		zs.avail_in = data.size();
+		zs.next_out = &deflated[0];
+		zs.avail_out = deflated.size();
+
+		beast::error_code ec;
+		ds.write(zs, zlib::Flush::finish, ec);
+		if (ec && ec != zlib::error::end_of_stream) {
+			throw beast::system_error{ ec };
+		}
+		out.append(deflated.data(), zs.total_out);
+
+		uint32_t crc = crc32(data);
+		uint32_t size = static_cast<uint32_t>(data.size());
+		for (int i = 0; i < 4; ++i) out += static_cast<char>((crc >> (8 * i)) & 0xFF);
+		for (int i = 0; i < 4; ++i) out += static_cast<char>((size >> (8 * i)) & 0xFF);
+		return out;
+	}
+
+	std::string serialize(http::status status, const std::string& etag,
+		const std::string& contentType, const char* encoding, const std::string& body) {
+		http::response<http::string_body> res{ status, 11 };
+		res.set(http::field::server, "Beast");
+		res.set(http::field::etag, etag);
+		res.set(http::field::vary, "Accept-Encoding");
+		res.keep_alive(false);
+		if (status != http::status::not_modified) {
+			res.set(http::field::content_type, contentType);
+			if (encoding) res.set(http::field::content_encoding, encoding);
+			res.body() = body;
+			res.prepare_payload();
+		}
+
+		std::ostringstream out;
+		out << res;
+		return out.str();
+	}
+}
+
+StaticPage::StaticPage(const std::string& body, const std::string& contentType) {
+	char etag[20];
+	snprintf(etag, sizeof(etag), "\"%08x\"", static_cast<unsigned>(crc32(body)));
+	etag_ = etag;
+
+	plain_ = serialize(http::status::ok, etag_, contentType, nullptr, body);
+	gzip_ = serialize(http::status::ok, etag_, contentType, "gzip", gzip(body));
+	notModified_ = serialize(http::status::not_modified, etag_, contentType, nullptr, "");
+}
+
+const std::string& StaticPage::select(const http::request<http::string_body>& request) const {
+	auto ifNoneMatch = request[http::field::if_none_match];
+	if (!ifNoneMatch.empty() && ifNoneMatch.find(etag_) != beast::string_view::npos) {
+		return notModified_;
+	}
+
+	auto acceptEncoding = request[http::field::accept_encoding];
+	if (acceptEncoding.find("gzip") != beast::string_view::npos) {
+		return gzip_;
+	}
+
+	return plain_;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include <boost/beast/http.hpp>
+
+//  ,    :
+//    ( , , )  ,
+//   gzip  304   ETag.   .
+class StaticPage {
+public:
+	StaticPage(const std::string& body, const std::string& contentType);
+
+	const std::string& select(const boost::beast::http::request<boost::beast::http::string_body>& request) const;
+
+private:
+	std::string etag_;
+	std::string plain_;
+	std::string gzip_;
+	std::string notModified_;
+};
@@ -0,0 +1,136 @@
+#include "suggest_index.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+    bool labelLess(char a, char b) {
+        return static_cast<unsigned char>(a) < static_cast<unsigned char>(b);
+    }
+}
+
+SuggestIndex::SuggestIndex(std::vector<std::pair<std::string, int>> words, std::size_t topK)
+    : topK_(std::min<std::size_t>(std::max<std::size_t>(topK, 1), 255))
+{
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end(),
+        [](const auto& a, const auto& b) { return a.first == b.first; }),
+        words.end());
+
+    //    ,      
+    offsets_.reserve(words.size() + 1);
+    weights_.reserve(words.size());
+    for (const auto& [w, weight] : words) {
+        offsets_.push_back(static_cast<uint32_t>(blob_.size()));
+        blob_ += w;
+        weights_.push_back(weight);
+    }
+    offsets_.push_back(static_cast<uint32_t>(blob_.size()));
+
+    nodes_.push_back(Node{ 0, 0, 0, 0, 0, 0 });
+    build(0, 0, static_cast<uint32_t>(weights_.size()), 0);
+    nodes_.shrink_to_fit();
+    top_.shrink_to_fit();
+}
+
+std::string SuggestIndex::word(uint32_t id) const {
+    return blob_.substr(offsets_[id], offsets_[id + 1] - offsets_[id]);
+}
+
+void SuggestIndex::build(uint32_t node, uint32_t lo, uint32_t hi, uint32_t depth) {
+    auto length = [this](uint32_t id) { return offsets_[id + 1] - offsets_[id]; };
+    auto charAt = [this](uint32_t id, uint32_t pos) { return blob_[offsets_[id] + pos]; };
+
+    std::vector<uint32_t> candidates;
+
+    // ,    ,     
+    uint32_t i = lo;
+    if (i < hi && length(i) == depth) {
+        candidates.push_back(i);
+        ++i;
+    }
+
+    //    ,        
+    std::vector<std::pair<uint32_t, uint32_t>> groups;
+    while (i < hi) {
+        uint32_t j = i + 1;
+        while (j < hi && charAt(j, depth) == charAt(i, depth)) ++j;
+        groups.emplace_back(i, j);
+        i = j;
+    }
+
+    //       :  
+    //        
+    std::vector<uint32_t> ends;
+    uint32_t first = static_cast<uint32_t>(nodes_.size());
+    for (const auto& [glo, ghi] : groups) {
+        uint32_t end = depth + 1;
+        uint32_t limit = std::min<uint32_t>(length(glo), depth + UINT16_MAX);
+        while (end < limit && charAt(glo, end) == charAt(ghi - 1, end)) ++end;
+        ends.push_back(end);
+        nodes_.push_back(Node{ 0, 0, offsets_[glo] + depth, static_cast<uint16_t>(end - depth), 0, 0 });
+    }
+    nodes_[node].firstChild = first;
+    nodes_[node].childCount = static_cast<uint16_t>(groups.size());
+
+    for (std::size_t g = 0; g < groups.size(); ++g) {
+        uint32_t child = first + static_cast<uint32_t>(g);
+        build(child, groups[g].first, groups[g].second, ends[g]);
+
+        const Node& c = nodes_[child];
+        candidates.insert(candidates.end(),
+            top_.begin() + c.topOffset, top_.begin() + c.topOffset + c.topCount);
+    }
+
+    // Top-k    top-k ,     
+    std::size_t count = std::min(topK_, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+        [this](uint32_t a, uint32_t b) {
+            return weights_[a] != weights_[b] ? weights_[a] > weights_[b] : a < b;
+        });
+
+    nodes_[node].topOffset = static_cast<uint32_t>(top_.size());
+    nodes_[node].topCount = static_cast<uint8_t>(count);
+    top_.insert(top_.end(), candidates.begin(), candidates.begin() + count);
+}
+
+std::vector<std::pair<std::string, int>>
+SuggestIndex::complete(const std::string& prefix, std::size_t limit) const {
+    std::vector<std::pair<std::string, int>> results;
+    if (nodes_.empty()) return results;
+
+    //     :   -   
+    uint32_t node = 0;
+    std::size_t pos = 0;
+    while (pos < prefix.size()) {
+        const Node& n = nodes_[node];
+        auto begin = nodes_.begin() + n.firstChild;
+        auto end = begin + n.childCount;
+        char ch = prefix[pos];
+        auto it = std::lower_bound(begin, end, ch,
+            [this](const Node& a, char c) { return labelLess(blob_[a.labelOffset], c); });
+        if (it == end || blob_[it->labelOffset] != ch) return results;
+
+        std::size_t length = std::min<std::size_t>(it->labelLength, prefix.size() - pos);
+        if (blob_.compare(it->labelOffset, length, prefix, pos, length) != 0) return results;
+        pos += length;
+        node = static_cast<uint32_t>(it - nodes_.begin());
+    }
+
+    const Node& n = nodes_[node];
+    std::size_t count = std::min<std::size_t>(limit, n.topCount);
+    results.reserve(count);
+    for (std::size_t k = 0; k < count; ++k) {
+        uint32_t id = top_[n.topOffset + k];
+        results.emplace_back(word(id), weights_[id]);
+    }
+    return results;
+}
+
+std::shared_ptr<const SuggestIndex> Suggester::snapshot() const {
+    return std::atomic_load(&index_);
+}
+
+void Suggester::update(std::shared_ptr<const SuggestIndex> index) {
+    std::atomic_store(&index_, std::move(index));
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <utility>
+
+//    (radix trie)  :  
+//       ,   - 
+//    .      top-k  
+// ,          .
+class SuggestIndex {
+public:
+    SuggestIndex(std::vector<std::pair<std::string, int>> words, std::size_t topK);
+
+    std::vector<std::pair<std::string, int>>
+        complete(const std::string& prefix, std::size_t limit) const;
+
+    std::size_t wordCount() const { return weights_.size(); }
+    std::size_t topK() const { return topK_; }
+
+private:
+    struct Node {
+        uint32_t firstChild;
+        uint32_t topOffset;
+        uint32_t labelOffset;   //    blob_
+        uint16_t labelLength;
+        uint16_t childCount;
+        uint8_t topCount;
+    };
+
+    void build(uint32_t node, uint32_t lo, uint32_t hi, uint32_t depth);
+    std::string word(uint32_t id) const;
+
+    std::size_t topK_;
+    std::string blob_;
+    std::vector<uint32_t> offsets_;
+    std::vector<int> weights_;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> top_;
+};
+
+//   :   , 
+//    ,   .
+class Suggester {
+public:
+    std::shared_ptr<const SuggestIndex> snapshot() const;
+    void update(std::shared_ptr<const SuggestIndex> index);
+
+private:
+    std::shared_ptr<const SuggestIndex> index_;
+};
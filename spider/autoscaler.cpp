@@ -0,0 +1,160 @@
+#include "autoscaler.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#endif
+
+namespace {
+    const double BaselineWeight = 0.05;
+    const double LimitSmoothing = 0.2;
+}
+
+Autoscaler::Autoscaler(StageControl fetch, StageControl parse, StageControl write,
+    std::function<double()> fetchedLoad, std::function<double()> parsedLoad,
+    std::chrono::seconds interval, double cpuTarget)
+    : fetch_(fetch), parse_(parse), write_(write),
+    fetchedLoad_(std::move(fetchedLoad)), parsedLoad_(std::move(parsedLoad)),
+    interval_(interval), cpuTarget_(cpuTarget),
+    fetchLimit_(static_cast<double>(fetch.limit.limit()))
+{
+}
+
+Autoscaler::~Autoscaler() {
+    if (!worker_.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+void Autoscaler::start() {
+    //   -   
+    if (interval_.count() <= 0) return;
+    worker_ = std::thread(&Autoscaler::run, this);
+}
+
+void Autoscaler::recordFetch(std::chrono::steady_clock::duration latency) {
+    std::lock_guard<std::mutex> lock(statsMtx_);
+    fetchWindow_.seconds += std::chrono::duration<double>(latency).count();
+    ++fetchWindow_.count;
+}
+
+void Autoscaler::recordCommit(std::chrono::steady_clock::duration latency, std::size_t documents) {
+    std::lock_guard<std::mutex> lock(statsMtx_);
+    commitWindow_.seconds += std::chrono::duration<double>(latency).count();
+    commitWindow_.count += documents;
+}
+
+double Autoscaler::processCpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0;
+    auto ticks = [](const FILETIME& t) {
+        return (static_cast<unsigned long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+    };
+    return (ticks(kernel) + ticks(user)) / 1e7;
+#else
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+void Autoscaler::run() {
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    double lastCpu = processCpuSeconds();
+    auto lastTime = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (!cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+        double cpuNow = processCpuSeconds();
+        auto now = std::chrono::steady_clock::now();
+        double wall = std::chrono::duration<double>(now - lastTime).count();
+        double cpu = wall > 0 ? (cpuNow - lastCpu) / (wall * cores) : 0;
+        lastCpu = cpuNow;
+        lastTime = now;
+
+        lock.unlock();
+        adjust(cpu);
+        lock.lock();
+    }
+}
+
+void Autoscaler::adjust(double cpu) {
+    Window fetch, commit;
+    {
+        std::lock_guard<std::mutex> lock(statsMtx_);
+        std::swap(fetch, fetchWindow_);
+        std::swap(commit, commitWindow_);
+    }
+
+    double fetchedLoad = fetchedLoad_();
+    double parsedLoad = parsedLoad_();
+    std::size_t fetchOld = fetch_.limit.limit();
+    std::size_t parseOld = parse_.limit.limit();
+    std::size_t writeOld = write_.limit.limit();
+
+    // :         ,
+    //  sqrt(limit)   ,    
+    double fetchLatency = 0;
+    if (fetch.count > 0 && fetch.seconds > 0) {
+        fetchLatency = fetch.seconds / fetch.count;
+        if (fetchBaseline_ == 0) fetchBaseline_ = fetchLatency;
+
+        double gradient = std::clamp(fetchBaseline_ / fetchLatency, 0.5, 1.0);
+        double target = fetchLimit_ * gradient + std::sqrt(fetchLimit_);
+
+        //   :     
+        if (fetchedLoad > 0.9) target = std::min(target, fetchLimit_ * 0.9);
+
+        fetchLimit_ = (1 - LimitSmoothing) * fetchLimit_ + LimitSmoothing * target;
+        fetchLimit_ = std::clamp(fetchLimit_, static_cast<double>(fetch_.min), static_cast<double>(fetch_.max));
+        fetchBaseline_ = (1 - BaselineWeight) * fetchBaseline_ + BaselineWeight * fetchLatency;
+    }
+    std::size_t fetchNew = static_cast<std::size_t>(std::lround(fetchLimit_));
+
+    //    :  ,     CPU
+    std::size_t parseNew = parseOld;
+    if (fetchedLoad > 0.5 && cpu < cpuTarget_) ++parseNew;
+    else if (fetchedLoad < 0.1 && parseNew > parse_.min) --parseNew;
+    parseNew = std::clamp(parseNew, parse_.min, parse_.max);
+
+    // :        -   ,
+    //    ,   
+    std::size_t writeNew = writeOld;
+    double commitLatency = 0;
+    if (commit.count > 0 && commit.seconds > 0) {
+        commitLatency = commit.seconds / commit.count;
+        if (commitBaseline_ == 0) commitBaseline_ = commitLatency;
+
+        if (commitLatency > 2 * commitBaseline_) writeNew = writeOld / 2;
+        else if (parsedLoad > 0.5) ++writeNew;
+
+        commitBaseline_ = (1 - BaselineWeight) * commitBaseline_ + BaselineWeight * commitLatency;
+    }
+    else if (parsedLoad == 0 && writeNew > write_.min) {
+        --writeNew;
+    }
+    writeNew = std::clamp(writeNew, write_.min, write_.max);
+
+    if (fetchNew == fetchOld && parseNew == parseOld && writeNew == writeOld) return;
+
+    fetch_.limit.setLimit(fetchNew);
+    parse_.limit.setLimit(parseNew);
+    write_.limit.setLimit(writeNew);
+
+    std::cout << "Autoscale: fetch " << fetchOld << " -> " << fetchNew
+        << ", parse " << parseOld << " -> " << parseNew
+        << ", db " << writeOld << " -> " << writeNew
+        << " (fetch " << static_cast<int>(fetchLatency * 1000) << " ms"
+        << ", commit " << static_cast<int>(commitLatency * 1000000) << " us/doc"
+        << ", cpu " << static_cast<int>(cpu * 100) << "%)\n";
+}
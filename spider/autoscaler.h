@@ -0,0 +1,61 @@
+#pragma once
+#include <functional>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "concurrency_limit.h"
+
+struct StageControl {
+    ConcurrencyLimit& limit;
+    std::size_t min;
+    std::size_t max;
+};
+
+//       :
+//  -    ,  -     CPU,
+//  - AIMD     .     0..1.
+class Autoscaler {
+public:
+    Autoscaler(StageControl fetch, StageControl parse, StageControl write,
+        std::function<double()> fetchedLoad, std::function<double()> parsedLoad,
+        std::chrono::seconds interval, double cpuTarget);
+    ~Autoscaler();
+
+    void start();
+
+    void recordFetch(std::chrono::steady_clock::duration latency);
+    void recordCommit(std::chrono::steady_clock::duration latency, std::size_t documents);
+
+private:
+    struct Window {
+        double seconds = 0;
+        std::size_t count = 0;
+    };
+
+    void run();
+    void adjust(double cpu);
+    static double processCpuSeconds();
+
+    StageControl fetch_;
+    StageControl parse_;
+    StageControl write_;
+    std::function<double()> fetchedLoad_;
+    std::function<double()> parsedLoad_;
+    std::chrono::seconds interval_;
+    double cpuTarget_;
+
+    std::mutex statsMtx_;
+    Window fetchWindow_;
+    Window commitWindow_;
+
+    //    -  " ",    
+    double fetchBaseline_ = 0;
+    double commitBaseline_ = 0;
+    double fetchLimit_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread worker_;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+//    :   push ,
+//      
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) : capacity_(capacity ? capacity : 1) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        notFull_.wait(lock, [this] { return items_.size() < capacity_; });
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        notEmpty_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty()) return false;
+
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    //  ,    (  maxItems),    
+    bool popBatch(std::vector<T>& batch, std::size_t maxItems) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        notEmpty_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty()) return false;
+
+        while (!items_.empty() && batch.size() < maxItems) {
+            batch.push_back(std::move(items_.front()));
+            items_.pop_front();
+        }
+        notFull_.notify_all();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        closed_ = true;
+        notEmpty_.notify_all();
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return items_.size();
+    }
+
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    std::size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    mutable std::mutex mtx_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+};
@@ -0,0 +1,443 @@
+#include "checkpoint.h"
+#include "record_io.h"
+
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char RecordAdded = 'A';
+    const char RecordDone = 'D';
+
+    //  :    URL,       
+    const std::streamoff SegmentHeaderSize = 24;
+
+    struct Record {
+        char type = 0;
+        uint64_t hash = 0;
+        CrawlTask task;
+    };
+
+    // FNV-1a   :    ,
+    //       std::hash
+    uint64_t urlHash(const Link& link) {
+        uint64_t h = 1469598103934665603ULL;
+        auto add = [&h](const std::string& part) {
+            for (unsigned char ch : part) {
+                h ^= ch;
+                h *= 1099511628211ULL;
+            }
+        };
+        add(link.protocol == ProtocolType::HTTPS ? "https://" : "http://");
+        add(link.hostName);
+        add(link.query);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    //        
+    bool readRecord(std::istream& in, Record& record) {
+        if (!in.get(record.type)) return false;
+
+        switch (record.type) {
+        case RecordDone:
+            record.hash = readU64(in);
+            break;
+        case RecordAdded:
+            record.task.link = readLink(in);
+            record.task.depth = static_cast<int>(readU32(in));
+            record.hash = urlHash(record.task.link);
+            break;
+        default:
+            return false;
+        }
+        return static_cast<bool>(in);
+    }
+
+    void writeTask(std::ostream& out, const CrawlTask& task) {
+        writeLink(out, task.link);
+        writeU32(out, static_cast<uint32_t>(task.depth));
+    }
+
+    CrawlTask readTask(std::istream& in) {
+        CrawlTask task;
+        task.link = readLink(in);
+        task.depth = static_cast<int>(readU32(in));
+        return task;
+    }
+
+    //    ,   
+    struct SegmentSection {
+        std::ifstream in;
+        uint64_t count = 0;
+
+        SegmentSection(const std::string& path, int section) : in(path, std::ios::binary) {
+            uint64_t counts[3];
+            for (auto& c : counts) c = readU64(in);
+            if (!in) throw std::runtime_error("Corrupt checkpoint segment: " + path);
+
+            std::streamoff offset = SegmentHeaderSize;
+            for (int s = 0; s < section && s < 2; ++s) offset += static_cast<std::streamoff>(counts[s] * 8);
+            in.seekg(offset);
+            count = counts[section];
+        }
+    };
+
+    //     ;        
+    class SegmentWriter {
+    public:
+        explicit SegmentWriter(const std::string& path) : path_(path), out_(path + ".tmp", std::ios::binary | std::ios::trunc) {
+            for (int s = 0; s < 3; ++s) writeU64(out_, 0);
+        }
+
+        void hash(uint64_t value) {
+            writeU64(out_, value);
+            ++counts_[section_];
+        }
+
+        void task(const CrawlTask& value) {
+            writeTask(out_, value);
+            ++counts_[section_];
+        }
+
+        void nextSection() { ++section_; }
+
+        //     
+        void commit() {
+            out_.seekp(0);
+            for (uint64_t count : counts_) writeU64(out_, count);
+            out_.close();
+            if (!out_) throw std::runtime_error("Failed to write checkpoint segment: " + path_);
+            fs::rename(path_ + ".tmp", path_);
+        }
+
+    private:
+        std::string path_;
+        std::ofstream out_;
+        uint64_t counts_[3] = {};
+        int section_ = 0;
+    };
+
+    //         
+    void mergeHashes(SegmentSection& a, SegmentSection& b, SegmentWriter& out) {
+        uint64_t restA = a.count, restB = b.count;
+        uint64_t x = restA ? readU64(a.in) : 0;
+        uint64_t y = restB ? readU64(b.in) : 0;
+        while (restA || restB) {
+            if (restB == 0 || (restA && x < y)) {
+                out.hash(x);
+                if (--restA) x = readU64(a.in);
+            }
+            else if (restA == 0 || y < x) {
+                out.hash(y);
+                if (--restB) y = readU64(b.in);
+            }
+            else {
+                out.hash(x);
+                if (--restA) x = readU64(a.in);
+                if (--restB) y = readU64(b.in);
+            }
+        }
+    }
+}
+
+Checkpoint::Checkpoint(const std::string& directory, int interval)
+    : directory_(directory), interval_(std::max(interval, 1))
+{
+    fs::create_directories(directory_);
+}
+
+Checkpoint::~Checkpoint() {
+    if (!worker_.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+std::string Checkpoint::logPath(uint32_t generation) const {
+    return (fs::path(directory_) / ("journal." + std::to_string(generation) + ".log")).string();
+}
+
+std::string Checkpoint::segmentPath(const Segment& segment) const {
+    return (fs::path(directory_) / ("segment." + std::to_string(segment.from) + "-"
+        + std::to_string(segment.to) + ".bin")).string();
+}
+
+std::vector<uint32_t> Checkpoint::logGenerations() const {
+    std::vector<uint32_t> generations;
+    for (const auto& entry : fs::directory_iterator(directory_)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("journal.", 0) == 0 && entry.path().extension() == ".log") {
+            generations.push_back(static_cast<uint32_t>(std::stoul(name.substr(8))));
+        }
+    }
+    std::sort(generations.begin(), generations.end());
+    return generations;
+}
+
+std::vector<Checkpoint::Segment> Checkpoint::segments() const {
+    std::vector<Segment> found;
+    for (const auto& entry : fs::directory_iterator(directory_)) {
+        std::string name = entry.path().filename().string();
+        std::size_t dash = name.find('-');
+        if (name.rfind("segment.", 0) == 0 && entry.path().extension() == ".bin" && dash != std::string::npos) {
+            found.push_back({ static_cast<uint32_t>(std::stoul(name.substr(8))),
+                static_cast<uint32_t>(std::stoul(name.substr(dash + 1))) });
+        }
+    }
+
+    //         
+    //  ,   :  
+    std::sort(found.begin(), found.end(), [](const Segment& a, const Segment& b) {
+        return a.from != b.from ? a.from < b.from : a.to > b.to;
+    });
+    std::vector<Segment> result;
+    for (const auto& segment : found) {
+        if (!result.empty() && segment.to <= result.back().to) continue;
+        result.push_back(segment);
+    }
+    return result;
+}
+
+void Checkpoint::clear() {
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory_)) {
+        fs::remove(entry.path(), ec);
+    }
+    visited_.clear();
+    generation_ = 1;
+}
+
+std::size_t Checkpoint::restore(Frontier& frontier) {
+    std::vector<Segment> segs = segments();
+    uint32_t compacted = segs.empty() ? 0 : segs.back().to;
+
+    //  ,       
+    std::unordered_set<uint64_t> done;
+    for (const auto& segment : segs) {
+        SegmentSection visited(segmentPath(segment), 0);
+        visited_.reserve(visited_.size() + visited.count);
+        for (uint64_t i = 0; i < visited.count; ++i) visited_.insert(readU64(visited.in));
+
+        SegmentSection finished(segmentPath(segment), 1);
+        for (uint64_t i = 0; i < finished.count; ++i) done.insert(readU64(finished.in));
+    }
+
+    // ,     
+    std::vector<CrawlTask> added;
+    generation_ = compacted + 1;
+    for (uint32_t generation : logGenerations()) {
+        if (generation <= compacted) continue;
+        generation_ = generation + 1;
+
+        std::ifstream in(logPath(generation), std::ios::binary);
+        Record record;
+        while (readRecord(in, record)) {
+            if (record.type == RecordDone) done.insert(record.hash);
+            else if (visited_.insert(record.hash).second) added.push_back(record.task);
+        }
+    }
+
+    std::size_t restored = 0;
+    std::vector<CrawlTask> batch;
+    auto pending = [&](const CrawlTask& task) {
+        if (done.count(urlHash(task.link))) return;
+        batch.push_back(task);
+        if (batch.size() >= 1000) {
+            restored += batch.size();
+            frontier.push(batch);
+            batch.clear();
+        }
+    };
+
+    for (const auto& segment : segs) {
+        SegmentSection tasks(segmentPath(segment), 2);
+        for (uint64_t i = 0; i < tasks.count; ++i) pending(readTask(tasks.in));
+    }
+    for (const auto& task : added) pending(task);
+
+    restored += batch.size();
+    frontier.push(batch);
+    return restored;
+}
+
+void Checkpoint::start() {
+    log_.open(logPath(generation_), std::ios::binary | std::ios::app);
+    if (!log_.is_open()) {
+        throw std::runtime_error("Failed to open checkpoint journal: " + logPath(generation_));
+    }
+    worker_ = std::thread(&Checkpoint::run, this);
+}
+
+std::vector<CrawlTask> Checkpoint::addNew(const std::vector<CrawlTask>& tasks) {
+    std::vector<CrawlTask> added;
+    added.reserve(tasks.size());
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (const auto& task : tasks) {
+        if (!visited_.insert(urlHash(task.link)).second) continue;
+
+        log_.put(RecordAdded);
+        writeTask(log_, task);
+        added.push_back(task);
+    }
+    return added;
+}
+
+void Checkpoint::markDone(const CrawlTask& task) {
+    uint64_t hash = urlHash(task.link);
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    log_.put(RecordDone);
+    writeU64(log_, hash);
+}
+
+void Checkpoint::run() {
+    auto nextSnapshot = std::chrono::steady_clock::now() + std::chrono::seconds(interval_);
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        //       ,  -   interval_
+        cv_.wait_for(lock, std::chrono::seconds(1), [this] { return stop_; });
+        log_.flush();
+
+        if (!stop_ && std::chrono::steady_clock::now() < nextSnapshot) continue;
+
+        //      ,    
+        uint32_t sealed = generation_++;
+        log_.close();
+        log_.open(logPath(generation_), std::ios::binary | std::ios::app);
+
+        lock.unlock();
+        compact(sealed);
+        lock.lock();
+
+        nextSnapshot = std::chrono::steady_clock::now() + std::chrono::seconds(interval_);
+        if (stop_) break;
+    }
+    log_.close();
+}
+
+void Checkpoint::writeSegment(const Segment& segment, const std::vector<uint32_t>& journals, bool oldest) {
+    std::vector<uint64_t> visited;
+    std::vector<uint64_t> done;
+    std::vector<std::pair<uint64_t, CrawlTask>> added;
+
+    for (uint32_t generation : journals) {
+        std::ifstream in(logPath(generation), std::ios::binary);
+        Record record;
+        while (readRecord(in, record)) {
+            if (record.type == RecordDone) {
+                done.push_back(record.hash);
+            }
+            else {
+                visited.push_back(record.hash);
+                added.emplace_back(record.hash, record.task);
+            }
+        }
+    }
+
+    std::sort(visited.begin(), visited.end());
+    visited.erase(std::unique(visited.begin(), visited.end()), visited.end());
+    std::sort(done.begin(), done.end());
+    done.erase(std::unique(done.begin(), done.end()), done.end());
+
+    SegmentWriter out(segmentPath(segment));
+    for (uint64_t hash : visited) out.hash(hash);
+
+    //           
+    out.nextSection();
+    if (!oldest) {
+        for (uint64_t hash : done) {
+            if (!std::binary_search(visited.begin(), visited.end(), hash)) out.hash(hash);
+        }
+    }
+
+    out.nextSection();
+    for (const auto& [hash, task] : added) {
+        if (!std::binary_search(done.begin(), done.end(), hash)) out.task(task);
+    }
+    out.commit();
+}
+
+void Checkpoint::mergeSegments(const Segment& older, const Segment& newer, bool oldest) {
+    SegmentWriter out(segmentPath({ older.from, newer.to }));
+    {
+        SegmentSection a(segmentPath(older), 0), b(segmentPath(newer), 0);
+        mergeHashes(a, b, out);
+    }
+
+    out.nextSection();
+    std::vector<uint64_t> newerDone;
+    {
+        SegmentSection a(segmentPath(older), 1), b(segmentPath(newer), 1);
+        newerDone.reserve(b.count);
+        for (uint64_t i = 0; i < b.count; ++i) newerDone.push_back(readU64(b.in));
+        if (!oldest) {
+            b.in.seekg(-static_cast<std::streamoff>(b.count * 8), std::ios::cur);
+            mergeHashes(a, b, out);
+        }
+    }
+
+    //   ,  ,   
+    out.nextSection();
+    {
+        SegmentSection a(segmentPath(older), 2), b(segmentPath(newer), 2);
+        for (uint64_t i = 0; i < a.count; ++i) {
+            CrawlTask task = readTask(a.in);
+            if (!std::binary_search(newerDone.begin(), newerDone.end(), urlHash(task.link))) out.task(task);
+        }
+        for (uint64_t i = 0; i < b.count; ++i) out.task(readTask(b.in));
+    }
+    out.commit();
+}
+
+void Checkpoint::compact(uint32_t generation) {
+    try {
+        std::vector<Segment> segs = segments();
+        uint32_t compacted = segs.empty() ? 0 : segs.back().to;
+
+        std::vector<uint32_t> journals;
+        std::error_code ec;
+        for (uint32_t g : logGenerations()) {
+            if (g <= compacted) fs::remove(logPath(g), ec);
+            else if (g <= generation) journals.push_back(g);
+        }
+        if (journals.empty()) return;
+
+        //          
+        Segment segment{ journals.front(), generation };
+        writeSegment(segment, journals, segs.empty());
+        for (uint32_t g : journals) fs::remove(logPath(g), ec);
+        segs.push_back(segment);
+
+        //    ,     :  
+        // O(log n),     O(log n) ,     
+        auto span = [](const Segment& s) { return s.to - s.from + 1; };
+        while (segs.size() >= 2 && span(segs[segs.size() - 2]) <= span(segs.back())) {
+            Segment newer = segs.back();
+            segs.pop_back();
+            Segment older = segs.back();
+            segs.pop_back();
+
+            mergeSegments(older, newer, segs.empty());
+            fs::remove(segmentPath(older), ec);
+            fs::remove(segmentPath(newer), ec);
+            segs.push_back({ older.from, newer.to });
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Checkpoint error: " << e.what() << "\n";
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+#include "frontier.h"
+
+//    :       ,
+//     .     
+// (    )     .
+//      URL  64- .
+class Checkpoint {
+public:
+    Checkpoint(const std::string& directory, int interval);
+    ~Checkpoint();
+
+    void clear();
+    std::size_t restore(Frontier& frontier);
+    void start();
+
+    std::vector<CrawlTask> addNew(const std::vector<CrawlTask>& tasks);
+    void markDone(const CrawlTask& task);
+
+private:
+    //     from  to
+    struct Segment {
+        uint32_t from;
+        uint32_t to;
+    };
+
+    void run();
+    void compact(uint32_t generation);
+    void writeSegment(const Segment& segment, const std::vector<uint32_t>& journals, bool oldest);
+    void mergeSegments(const Segment& older, const Segment& newer, bool oldest);
+
+    std::string logPath(uint32_t generation) const;
+    std::string segmentPath(const Segment& segment) const;
+    std::vector<uint32_t> logGenerations() const;
+    std::vector<Segment> segments() const;
+
+    std::string directory_;
+    int interval_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::unordered_set<uint64_t> visited_;
+    std::ofstream log_;
+    uint32_t generation_ = 0;
+    bool stop_ = false;
+
+    std::thread worker_;
+};
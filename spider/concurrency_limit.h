@@ -0,0 +1,48 @@
+#pragma once
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+//        .
+//      acquire,    .  close  ,
+//         .
+class ConcurrencyLimit {
+public:
+    explicit ConcurrencyLimit(std::size_t limit) : limit_(std::max<std::size_t>(limit, 1)) {}
+
+    void acquire() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_.wait(lock, [this] { return active_ < limit_ || closed_; });
+        ++active_;
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        --active_;
+        cv_.notify_one();
+    }
+
+    void setLimit(std::size_t limit) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        limit_ = std::max<std::size_t>(limit, 1);
+        cv_.notify_all();
+    }
+
+    std::size_t limit() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return limit_;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        closed_ = true;
+        cv_.notify_all();
+    }
+
+private:
+    std::size_t limit_;
+    std::size_t active_ = 0;
+    bool closed_ = false;
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+};
@@ -4,6 +4,11 @@
 #include <boost/locale.hpp>
 #include <regex>
 #include <map>
+#include <optional>
+#include <string_view>
+#include <cstddef>
+#include <unordered_map>
+#include "snippet_text.h"
 
 using namespace std;
 namespace ba = boost::algorithm;
@@ -14,12 +19,14 @@ Database::Database(const string& host,
     const string& port,
     const string& dbname,
     const string& user,
-    const string& password) :
+    const string& password,
+    const string& searchBackend) :
     conn_("host=" + host +
         " port=" + port +
         " dbname=" + dbname +
         " user=" + user +
-        " password=" + password)
+        " password=" + password),
+    backend_(makeSearchBackend(searchBackend))
 {
     if (!conn_.is_open()) {
         throw runtime_error("Failed to connect to database");
@@ -41,132 +48,199 @@ void Database::initializeSchema() {
         )
     )");
 
-    txn.exec(R"(
-        CREATE TABLE IF NOT EXISTS words (
-            id SERIAL PRIMARY KEY,
-            word TEXT UNIQUE NOT NULL,
-            CONSTRAINT word_length CHECK (length(word) BETWEEN 3 AND 32)
-        )
-    )");
+    //    -
+    txn.exec("ALTER TABLE documents ADD COLUMN IF NOT EXISTS simhash BIGINT");
+    txn.exec("ALTER TABLE documents ADD COLUMN IF NOT EXISTS canonical_id INTEGER "
+        "REFERENCES documents(id) ON DELETE SET NULL");
 
-    txn.exec(R"(
-        CREATE TABLE IF NOT EXISTS document_words (
-            document_id INTEGER REFERENCES documents(id) ON DELETE CASCADE,
-            word_id INTEGER REFERENCES words(id) ON DELETE CASCADE,
-            count INTEGER NOT NULL,
-            PRIMARY KEY (document_id, word_id)
-        )
-    )");
+    //    :     HTML  content
+    txn.exec("ALTER TABLE documents ADD COLUMN IF NOT EXISTS snippet BYTEA");
 
-    //    
-    txn.exec("CREATE INDEX IF NOT EXISTS idx_word_text ON words(word)");
-    txn.exec("CREATE INDEX IF NOT EXISTS idx_document_words_word ON document_words(word_id)");
-    txn.exec("CREATE INDEX IF NOT EXISTS idx_document_words_doc ON document_words(document_id)");
+    //      
+    backend_->initializeSchema(txn);
 
     txn.commit();
 }
 
-void Database::saveDocument(const string& url, const string& title, const string& content) {
-    work txn(conn_);
+shared_ptr<SimHashIndex> Database::enableDeduplication(int maxDistance) {
+    dedup_ = make_shared<SimHashIndex>(maxDistance);
 
-    //    
-    auto doc = txn.exec_params1(
-        "INSERT INTO documents (url, title, content, last_crawled) "
-        "VALUES ($1, $2, $3, NOW()) "
-        "ON CONFLICT (url) DO UPDATE "
-        "SET title = $2, content = $3, last_crawled = NOW() "
-        "RETURNING id",
-        url, title, content
+    //      ,    
+    work txn(conn_);
+    auto result = txn.exec(
+        "SELECT id, simhash FROM documents "
+        "WHERE simhash IS NOT NULL AND canonical_id IS NULL"
     );
-    int doc_id = doc[0].as<int>();
+
+    for (const auto& row : result) {
+        dedup_->add(row[0].as<int>(), static_cast<uint64_t>(row[1].as<long long>()));
+    }
+
+    return dedup_;
+}
+
+void Database::useDeduplication(shared_ptr<SimHashIndex> index) {
+    dedup_ = move(index);
+}
+
+ParsedDocument parseDocument(const string& url, const string& title, const string& content) {
+    static const regex html_regex("<[^>]*>");
+    static const regex punct_regex("[^\\w\\s]");
+
+    //   :    
+    ParsedDocument document{ url, decodeHtmlText(title), content, "", encodeSnippetText(content), {}, {} };
 
     //  
-    string text = regex_replace(content, regex("<[^>]*>"), " "); //  HTML
-    text = regex_replace(text, regex("[^\\w\\s]"), " "); //  
+    string text = regex_replace(content, html_regex, " "); //  HTML
+    text = regex_replace(text, punct_regex, " "); //  
     text = bl::to_lower(bl::normalize(text)); //    
 
     //  
-    map<string, int> word_counts;
     vector<string> words;
     ba::split(words, text, ba::is_any_of(" \t\n\r"), ba::token_compress_on);
 
     for (const auto& word : words) {
         if (word.length() >= 3 && word.length() <= 32) {
-            word_counts[word]++;
+            document.wordCounts[word]++;
         }
     }
+    document.text = move(text);
 
-    //    
-    for (const auto& [word, count] : word_counts) {
-        //  
-        auto word_row = txn.exec_params1(
-            "INSERT INTO words (word) VALUES ($1) "
-            "ON CONFLICT (word) DO UPDATE SET word = $1 "
-            "RETURNING id",
-            word
-        );
-        int word_id = word_row[0].as<int>();
-
-        //    
-        txn.exec_params(
-            "INSERT INTO document_words (document_id, word_id, count) "
-            "VALUES ($1, $2, $3) "
-            "ON CONFLICT (document_id, word_id) DO UPDATE "
-            "SET count = $3",
-            doc_id, word_id, count
-        );
+    if (document.wordCounts.size() >= SimHashMinTerms) {
+        document.fingerprint = simhash(document.wordCounts);
     }
+    return document;
+}
 
-    txn.commit();
+void Database::saveDocument(const string& url, const string& title, const string& content) {
+    saveDocuments({ parseDocument(url, title, content) });
 }
 
-vector<tuple<string, string, int>> Database::search(const vector<string>& words) {
-    work txn(conn_);
+void Database::saveDocuments(const vector<ParsedDocument>& documents) {
+    if (documents.empty()) return;
 
-    //  SQL-
-    string sql = R"(
-        WITH matched_words AS (
-            SELECT id FROM words WHERE word IN ()";
+    //  URL    INSERT ... ON CONFLICT :   
+    vector<const ParsedDocument*> batch;
+    unordered_map<string, size_t> positions;
+    for (const auto& document : documents) {
+        auto [it, inserted] = positions.emplace(document.url, batch.size());
+        if (inserted) batch.push_back(&document);
+        else batch[it->second] = &document;
+    }
 
-    //     
-    for (size_t i = 0; i < words.size(); ++i) {
-        sql += "$" + to_string(i + 1);
-        if (i != words.size() - 1) sql += ",";
+    // -       .
+    //        ,  
+    //      :  id    INSERT
+    vector<optional<int>> canonical(batch.size());
+    vector<optional<size_t>> sameBatch(batch.size());
+    if (dedup_) {
+        SimHashIndex batchIndex(dedup_->maxDistance());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!batch[i]->fingerprint) continue;
+            int near = dedup_->findNear(*batch[i]->fingerprint);
+            if (near >= 0) {
+                canonical[i] = near;
+                continue;
+            }
+            near = batchIndex.findNear(*batch[i]->fingerprint);
+            if (near >= 0) sameBatch[i] = near;
+            else batchIndex.add(static_cast<int>(i), *batch[i]->fingerprint);
+        }
     }
 
-    sql += R"()
-        ),
-        relevant_docs AS (
-            SELECT dw.document_id, SUM(dw.count) as relevance
-            FROM document_words dw
-            JOIN matched_words mw ON dw.word_id = mw.id
-            GROUP BY dw.document_id
-            HAVING COUNT(DISTINCT dw.word_id) = )" + to_string(words.size()) + R"(
-        )
-        SELECT d.url, d.title, rd.relevance
-        FROM documents d
-        JOIN relevant_docs rd ON d.id = rd.document_id
-        ORDER BY rd.relevance DESC
-        LIMIT 10
-    )";
-
-    //  
-    vector<const char*> params;
-    for (const auto& word : words) {
-        params.push_back(word.c_str());
+    work txn(conn_);
+
+    //        
+    string sql = "INSERT INTO documents (url, title, content, snippet, last_crawled, simhash, canonical_id) VALUES ";
+    params values;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        size_t n = i * 6;
+        if (i != 0) sql += ",";
+        sql += "($" + to_string(n + 1) + ",$" + to_string(n + 2) + ",$" + to_string(n + 3)
+            + ",$" + to_string(n + 4) + ",NOW(),$" + to_string(n + 5) + ",$" + to_string(n + 6) + ")";
+
+        bool alias = canonical[i] || sameBatch[i];
+        values.append(batch[i]->url);
+        values.append(batch[i]->title);
+        values.append(alias ? optional<string>() : optional<string>(batch[i]->content));
+        // binary_cast  libpqxx 7.7  basic_string_view<byte> (bytea)
+        using Bytes = basic_string_view<std::byte>;
+        values.append(alias ? optional<Bytes>() : optional<Bytes>(binary_cast(batch[i]->snippet)));
+        values.append(batch[i]->fingerprint
+            ? optional<long long>(static_cast<long long>(*batch[i]->fingerprint)) : optional<long long>());
+        values.append(canonical[i]);
+    }
+    sql += " ON CONFLICT (url) DO UPDATE "
+        "SET title = EXCLUDED.title, content = EXCLUDED.content, snippet = EXCLUDED.snippet, last_crawled = EXCLUDED.last_crawled, "
+        "simhash = EXCLUDED.simhash, canonical_id = EXCLUDED.canonical_id "
+        "RETURNING id, url";
+
+    vector<int> ids(batch.size());
+    for (const auto& row : txn.exec_params(sql, values)) {
+        ids[positions.at(row[1].as<string>())] = row[0].as<int>();
     }
 
-    //  
-    auto result = txn.exec_params(sql, params);
-    vector<tuple<string, string, int>> results;
+    vector<bool> indexed(batch.size(), false);
+    vector<int> aliases;
+    vector<SearchBackend::IndexedDocument> indexable;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (sameBatch[i]) {
+            canonical[i] = ids[*sameBatch[i]];
+            txn.exec_params("UPDATE documents SET canonical_id = $2 WHERE id = $1", ids[i], *canonical[i]);
+        }
 
-    for (const auto& row : result) {
-        results.emplace_back(
-            row[0].as<string>(), // url
-            row[1].as<string>(), // title
-            row[2].as<int>()     // relevance
-        );
+        //     URL   
+        if (canonical[i] == ids[i]) {
+            txn.exec_params(
+                "UPDATE documents SET content = $2, snippet = $3, canonical_id = NULL WHERE id = $1",
+                ids[i], batch[i]->content, binary_cast(batch[i]->snippet)
+            );
+            canonical[i].reset();
+            indexed[i] = true;
+        }
+
+        if (canonical[i]) aliases.push_back(ids[i]);
+        else indexable.emplace_back(ids[i], batch[i]);
+    }
+
+    //    ,    
+    backend_->removeDocuments(txn, aliases);
+    backend_->indexDocuments(txn, indexable);
+
+    txn.commit();
+
+    if (dedup_) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!canonical[i] && !indexed[i] && batch[i]->fingerprint) {
+                dedup_->add(ids[i], *batch[i]->fingerprint);
+            }
+        }
     }
+}
 
-    return results;
+vector<SearchHit> Database::search(const vector<string>& words) {
+    return searchBatch({ { words, 10, 0 } }).front();
+}
+
+vector<vector<SearchHit>> Database::searchBatch(const vector<SearchQuery>& queries) {
+    if (queries.empty()) return {};
+
+    work txn(conn_);
+    return backend_->searchBatch(txn, queries);
+}
+
+vector<pair<string, int>> Database::wordFrequencies() {
+    work txn(conn_);
+    return backend_->wordFrequencies(txn);
+}
+
+long long Database::searchIndexSize() {
+    work txn(conn_);
+    return backend_->indexSize(txn);
+}
+
+void Database::removeDocuments(const string& urlPrefix) {
+    work txn(conn_);
+    txn.exec_params("DELETE FROM documents WHERE starts_with(url, $1)", urlPrefix);
+    txn.commit();
 }
\ No newline at end of file
@@ -3,6 +3,32 @@
 #include <vector>
 #include <string>
 #include <tuple>
+#include <memory>
+#include <map>
+#include <optional>
+#include <cstdint>
+#include "simhash.h"
+#include "search_backend.h"
+
+struct SearchQuery {
+    std::vector<std::string> words;
+    int limit;
+    int offset;
+};
+
+struct ParsedDocument {
+    std::string url;
+    std::string title;
+    std::string content;
+    std::string text;   //      
+    std::string snippet;    //    
+    std::map<std::string, int> wordCounts;
+    std::optional<uint64_t> fingerprint;    // ,    SimHashMinTerms
+};
+
+ParsedDocument parseDocument(const std::string& url,
+    const std::string& title,
+    const std::string& content);
 
 class Database {
 public:
@@ -10,16 +36,32 @@ public:
         const std::string& port,
         const std::string& dbname,
         const std::string& user,
-        const std::string& password);
+        const std::string& password,
+        const std::string& searchBackend = "words");
 
     void initializeSchema();
+    std::shared_ptr<SimHashIndex> enableDeduplication(int maxDistance);
+    void useDeduplication(std::shared_ptr<SimHashIndex> index);
+
     void saveDocument(const std::string& url,
         const std::string& title,
         const std::string& content);
+    void saveDocuments(const std::vector<ParsedDocument>& documents);
 
-    std::vector<std::tuple<std::string, std::string, int>>
+    std::vector<SearchHit>
         search(const std::vector<std::string>& words);
 
+    std::vector<std::vector<SearchHit>>
+        searchBatch(const std::vector<SearchQuery>& queries);
+
+    std::vector<std::pair<std::string, int>> wordFrequencies();
+
+    const char* searchBackend() const { return backend_->name(); }
+    long long searchIndexSize();
+    void removeDocuments(const std::string& urlPrefix);
+
 private:
     pqxx::connection conn_;
+    std::shared_ptr<SimHashIndex> dedup_;
+    std::unique_ptr<SearchBackend> backend_;
 };
\ No newline at end of file
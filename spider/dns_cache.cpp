@@ -0,0 +1,90 @@
+#include "dns_cache.h"
+
+#include <boost/asio/post.hpp>
+#include <boost/system/system_error.hpp>
+#include <functional>
+#include <algorithm>
+
+namespace net = boost::asio;
+using tcp = boost::asio::ip::tcp;
+
+DnsCache::DnsCache(std::chrono::seconds ttl, std::chrono::seconds negativeTtl, std::size_t threads)
+    : ttl_(ttl), negativeTtl_(negativeTtl)
+{
+    for (std::size_t i = 0; i < std::max<std::size_t>(threads, 1); ++i) {
+        lookups_.push_back(std::make_unique<Lookup>());
+        Lookup& lookup = *lookups_.back();
+        lookup.thread = std::thread([&lookup] { lookup.ioc.run(); });
+    }
+}
+
+DnsCache::~DnsCache() {
+    //     broken_promise
+    for (auto& lookup : lookups_) {
+        lookup->work.reset();
+        lookup->ioc.stop();
+        lookup->thread.join();
+    }
+}
+
+DnsCache::Results DnsCache::resolve(const std::string& host, const std::string& service) {
+    std::string key = host + ":" + service;
+    std::shared_future<Results> results;
+    std::shared_ptr<std::promise<Results>> promise;
+    uint64_t id = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto now = std::chrono::steady_clock::now();
+        sweep(now);
+
+        auto it = entries_.find(key);
+        if (it != entries_.end() && (!it->second.ready || now < it->second.expires)) {
+            //      
+            results = it->second.results;
+        }
+        else {
+            promise = std::make_shared<std::promise<Results>>();
+            Entry& entry = entries_[key];
+            entry.results = promise->get_future().share();
+            entry.ready = false;
+            entry.id = id = ++nextId_;
+            results = entry.results;
+        }
+    }
+
+    if (promise) {
+        Lookup& lookup = *lookups_[std::hash<std::string>{}(key) % lookups_.size()];
+        net::post(lookup.ioc, [this, &lookup, key, host, service, id, promise] {
+            lookup.resolver.async_resolve(host, service,
+                [this, key, id, promise](const boost::system::error_code& ec, Results found) {
+                    complete(key, id, static_cast<bool>(ec));
+                    if (ec) promise->set_exception(std::make_exception_ptr(boost::system::system_error(ec)));
+                    else promise->set_value(std::move(found));
+                });
+        });
+    }
+
+    //       
+    return results.get();
+}
+
+void DnsCache::sweep(std::chrono::steady_clock::time_point now) {
+    //   ttl   :      
+    if (now < nextSweep_) return;
+    nextSweep_ = now + ttl_;
+
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.ready && it->second.expires <= now) it = entries_.erase(it);
+        else ++it;
+    }
+}
+
+void DnsCache::complete(const std::string& key, uint64_t id, bool failed) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = entries_.find(key);
+    if (it == entries_.end() || it->second.id != id) return;
+
+    it->second.ready = true;
+    it->second.expires = std::chrono::steady_clock::now() + (failed ? negativeTtl_ : ttl_);
+}
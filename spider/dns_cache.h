@@ -0,0 +1,56 @@
+#pragma once
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <unordered_map>
+#include <cstdint>
+
+//   DNS   .      ,
+//       ,   .
+// getaddrinfo   TTL ,     .
+class DnsCache {
+public:
+    using Results = boost::asio::ip::tcp::resolver::results_type;
+
+    DnsCache(std::chrono::seconds ttl, std::chrono::seconds negativeTtl, std::size_t threads);
+    ~DnsCache();
+
+    //         
+    Results resolve(const std::string& host, const std::string& service);
+
+private:
+    struct Entry {
+        std::shared_future<Results> results;
+        std::chrono::steady_clock::time_point expires;
+        uint64_t id = 0;
+        bool ready = false;
+    };
+
+    struct Lookup {
+        boost::asio::io_context ioc;
+        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work{ ioc.get_executor() };
+        boost::asio::ip::tcp::resolver resolver{ ioc };
+        std::thread thread;
+    };
+
+    void complete(const std::string& key, uint64_t id, bool failed);
+    void sweep(std::chrono::steady_clock::time_point now);
+
+    std::chrono::seconds ttl_;
+    std::chrono::seconds negativeTtl_;
+
+    std::mutex mtx_;
+    std::unordered_map<std::string, Entry> entries_;
+    uint64_t nextId_ = 0;
+    std::chrono::steady_clock::time_point nextSweep_;
+
+    //   resolver    getaddrinfo:     
+    std::vector<std::unique_ptr<Lookup>> lookups_;
+};
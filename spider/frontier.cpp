@@ -0,0 +1,233 @@
+#include "frontier.h"
+#include "record_io.h"
+
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+Frontier::Frontier(const std::string& directory, std::size_t blockSize)
+    : directory_(directory), blockSize_(std::max<std::size_t>(blockSize, 2))
+{
+    fs::create_directories(directory_);
+
+    //          
+    for (const auto& entry : fs::directory_iterator(directory_)) {
+        if (entry.path().extension() == ".seg") {
+            fs::remove(entry.path());
+        }
+    }
+
+    tail_.reserve(blockSize_);
+    spiller_ = std::thread(&Frontier::spillLoop, this);
+}
+
+Frontier::~Frontier() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    spillCv_.notify_all();
+    spiller_.join();
+
+    std::error_code ec;
+    for (const auto& segment : segments_) {
+        if (!segment.path.empty()) fs::remove(segment.path, ec);
+    }
+}
+
+void Frontier::push(const std::vector<CrawlTask>& tasks) {
+    if (tasks.empty()) return;
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (const auto& task : tasks) {
+        //     ,       
+        bool onlyHead = !loadedReady_ && !loading_ && segments_.empty() && !writing_
+            && pending_.empty() && tail_.empty();
+
+        if (onlyHead && head_.size() < blockSize_) {
+            head_.push_back(task);
+        }
+        else {
+            tail_.push_back(task);
+            if (tail_.size() >= blockSize_) {
+                pending_.push_back(std::move(tail_));
+                tail_ = Batch();
+                tail_.reserve(blockSize_);
+                spillCv_.notify_one();
+            }
+        }
+        ++size_;
+    }
+    cv_.notify_all();
+}
+
+bool Frontier::pop(CrawlTask& task) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        if (head_.empty()) refill();
+
+        if (!head_.empty()) {
+            task = std::move(head_.front());
+            head_.pop_front();
+            --size_;
+            ++inFlight_;
+            if (needLoad()) spillCv_.notify_one();
+            return true;
+        }
+
+        if (closed_ && size_ == 0 && inFlight_ == 0) return false;
+
+        spillCv_.notify_one();
+        cv_.wait(lock);
+    }
+}
+
+void Frontier::close() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        closed_ = true;
+    }
+    cv_.notify_all();
+}
+
+void Frontier::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (--inFlight_ != 0) return;
+    }
+    cv_.notify_all();
+}
+
+std::size_t Frontier::size() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return size_;
+}
+
+bool Frontier::needLoad() const {
+    return !loadedReady_ && !loading_ && !segments_.empty() && head_.size() <= blockSize_ / 2;
+}
+
+void Frontier::refill() {
+    if (loadedReady_) {
+        head_.assign(std::make_move_iterator(loaded_.begin()), std::make_move_iterator(loaded_.end()));
+        loaded_.clear();
+        loadedReady_ = false;
+        spillCv_.notify_one();
+        return;
+    }
+
+    //      :    
+    if (loading_ || writing_) return;
+    if (!segments_.empty()) {
+        if (segments_.front().path.empty()) {
+            Batch& data = segments_.front().data;
+            head_.assign(std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
+            segments_.pop_front();
+        }
+        return;
+    }
+
+    Batch* next = !pending_.empty() ? &pending_.front() : &tail_;
+    head_.assign(std::make_move_iterator(next->begin()), std::make_move_iterator(next->end()));
+    if (!pending_.empty()) pending_.pop_front();
+    else tail_.clear();
+}
+
+void Frontier::spillLoop() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        spillCv_.wait(lock, [this] { return stop_ || needLoad() || !pending_.empty(); });
+        if (stop_) break;
+
+        //   :     
+        if (needLoad()) {
+            Segment segment = std::move(segments_.front());
+            segments_.pop_front();
+            loading_ = true;
+
+            lock.unlock();
+            Batch batch;
+            if (segment.path.empty()) {
+                batch = std::move(segment.data);
+            }
+            else {
+                try {
+                    batch = readSegment(segment.path);
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "Frontier segment lost: " << e.what() << "\n";
+                }
+                std::error_code ec;
+                fs::remove(segment.path, ec);
+            }
+            lock.lock();
+
+            size_ -= segment.count - batch.size();
+            loaded_ = std::move(batch);
+            loading_ = false;
+            loadedReady_ = true;
+            cv_.notify_all();
+            continue;
+        }
+
+        Batch batch = std::move(pending_.front());
+        pending_.pop_front();
+        writing_ = true;
+        std::string path = (fs::path(directory_) / (std::to_string(nextSegment_++) + ".seg")).string();
+
+        lock.unlock();
+        Segment segment{ path, batch.size(), {} };
+        try {
+            writeSegment(path, batch);
+        }
+        catch (const std::exception& e) {
+            //      ,    
+            std::cerr << "Frontier spill failed: " << e.what() << "\n";
+            segment.path.clear();
+            segment.data = std::move(batch);
+        }
+        lock.lock();
+
+        segments_.push_back(std::move(segment));
+        writing_ = false;
+        cv_.notify_all();
+    }
+}
+
+void Frontier::writeSegment(const std::string& path, const Batch& batch) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open frontier segment: " + path);
+    }
+
+    writeU32(out, static_cast<uint32_t>(batch.size()));
+    for (const auto& task : batch) {
+        writeLink(out, task.link);
+        writeU32(out, static_cast<uint32_t>(task.depth));
+    }
+
+    if (!out.flush()) {
+        throw std::runtime_error("Failed to write frontier segment: " + path);
+    }
+}
+
+Frontier::Batch Frontier::readSegment(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Failed to open frontier segment: " + path);
+    }
+
+    Batch batch(readU32(in));
+    for (auto& task : batch) {
+        task.link = readLink(in);
+        task.depth = static_cast<int>(readU32(in));
+    }
+
+    if (!in) {
+        throw std::runtime_error("Corrupted frontier segment: " + path);
+    }
+    return batch;
+}
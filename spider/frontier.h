@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+#include "link.h"
+
+struct CrawlTask {
+    Link link;
+    int depth;
+};
+
+//     :      ,
+//            .
+//       ,    .
+class Frontier {
+public:
+    Frontier(const std::string& directory, std::size_t blockSize);
+    ~Frontier();
+
+    void push(const std::vector<CrawlTask>& tasks);
+    bool pop(CrawlTask& task);
+    void close();
+
+    //  pop      (    ).
+    //  close pop  false,         
+    void finish();
+
+    std::size_t size() const;
+
+private:
+    using Batch = std::vector<CrawlTask>;
+
+    struct Segment {
+        std::string path;
+        std::size_t count;
+        Batch data;
+    };
+
+    void spillLoop();
+    bool needLoad() const;
+    void refill();
+
+    static void writeSegment(const std::string& path, const Batch& batch);
+    static Batch readSegment(const std::string& path);
+
+    std::string directory_;
+    std::size_t blockSize_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::condition_variable spillCv_;
+
+    //  : head_, loaded_, segments_, writing, pending_, tail_
+    std::deque<CrawlTask> head_;
+    Batch loaded_;
+    bool loadedReady_ = false;
+    bool loading_ = false;
+    std::deque<Segment> segments_;
+    bool writing_ = false;
+    std::deque<Batch> pending_;
+    Batch tail_;
+
+    std::size_t size_ = 0;
+    std::size_t inFlight_ = 0;   //  pop,     finish
+    uint64_t nextSegment_ = 0;
+    bool closed_ = false;
+    bool stop_ = false;
+
+    std::thread spiller_;
+};
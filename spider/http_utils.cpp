@@ -36,7 +36,7 @@ bool isText(const boost::beast::multi_buffer::const_buffers_type& b)
 	return true;
 }
 
-std::string getHtmlContent(const Link& link)
+std::string getHtmlContent(const Link& link, DnsCache& dns)
 {
 
 	std::string result;
@@ -67,8 +67,7 @@ std::string getHtmlContent(const Link& link)
 				throw beast::system_error{ ec };
 			}
 
-			ip::tcp::resolver resolver(ioc);
-			get_lowest_layer(stream).connect(resolver.resolve({ host, "https" }));
+			get_lowest_layer(stream).connect(dns.resolve(host, "https"));
 			get_lowest_layer(stream).expires_after(std::chrono::seconds(30));
 
 
@@ -104,10 +103,9 @@ std::string getHtmlContent(const Link& link)
 		}
 		else
 		{
-			tcp::resolver resolver(ioc);
 			beast::tcp_stream stream(ioc);
 
-			auto const results = resolver.resolve(host, "http");
+			auto const results = dns.resolve(host, "http");
 
 			stream.connect(results);
 
@@ -2,5 +2,6 @@
 #include <vector>
 #include <string>
 #include "link.h"
+#include "dns_cache.h"
 
-std::string getHtmlContent(const Link& link);
\ No newline at end of file
+std::string getHtmlContent(const Link& link, DnsCache& dns);
\ No newline at end of file
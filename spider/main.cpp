@@ -1,105 +1,187 @@
 #include <iostream>
 #include <thread>
-#include <mutex>
-#include <queue>
-#include <condition_variable>
-#include <functional>
+#include <regex>
+#include <algorithm>
+#include <optional>
 #include <boost/algorithm/string.hpp>
+#include <boost/locale.hpp>
 #include "http_utils.h"
 #include "database.h"
 #include "config_parser.h"
+#include "frontier.h"
+#include "checkpoint.h"
+#include "bounded_queue.h"
+#include "autoscaler.h"
 
-//     
-std::mutex mtx;
-std::condition_variable cv;
-std::queue<std::function<void()>> tasks;
-bool exitThreadPool = false;
+using namespace std;
 
-void threadPoolWorker() {
-    std::unique_lock<std::mutex> lock(mtx);
-    while (!exitThreadPool || !tasks.empty()) {
-        if (tasks.empty()) {
-            cv.wait(lock);
+struct FetchedPage {
+    CrawlTask task;
+    std::string html;
+};
+
+struct ParsedPage {
+    CrawlTask task;
+    ParsedDocument document;
+};
+
+//  :  
+void fetchWorker(Frontier& frontier, Checkpoint& checkpoint, DnsCache& dns,
+    BoundedQueue<FetchedPage>& fetched, ConcurrencyLimit& limit, Autoscaler& autoscaler) {
+    CrawlTask task;
+    while (true) {
+        limit.acquire();
+        if (!frontier.pop(task)) {
+            limit.release();
+            break;
+        }
+
+        const Link& link = task.link;
+        std::cout << "Processing: " << link.hostName << link.query << " (depth: " << task.depth << ")\n";
+
+        auto started = std::chrono::steady_clock::now();
+        std::string html = getHtmlContent(link, dns);
+        autoscaler.recordFetch(std::chrono::steady_clock::now() - started);
+
+        if (html.empty()) {
+            std::cerr << "Failed to get content from: " << link.hostName << link.query << "\n";
+            checkpoint.markDone(task);
+            frontier.finish();
         }
         else {
-            auto task = tasks.front();
-            tasks.pop();
-            lock.unlock();
-            task();
-            lock.lock();
+            fetched.push({ std::move(task), std::move(html) });
         }
+        limit.release();
     }
 }
 
-void processLink(const Link& link, int depth, Database& db) {
-    try {
-        std::cout << "Processing: " << link.hostName << link.query << " (depth: " << depth << ")\n";
+ParsedPage parsePage(FetchedPage& page, Frontier& frontier, Checkpoint& checkpoint) {
+    const Link& link = page.task.link;
+    const std::string& html = page.html;
+    int depth = page.task.depth;
 
-        std::string html = getHtmlContent(link);
-        if (html.empty()) {
-            std::cerr << "Failed to get content from: " << link.hostName << link.query << "\n";
-            return;
-        }
-
-        //  
-        size_t titleStart = html.find("<title>");
-        size_t titleEnd = html.find("</title>");
-        std::string title = (titleStart != std::string::npos && titleEnd != std::string::npos) ?
-            html.substr(titleStart + 7, titleEnd - (titleStart + 7)) : "No title";
-
-        //    
-        std::string fullUrl = (link.protocol == ProtocolType::HTTPS ? "https://" : "http://") +
-            link.hostName + link.query;
-        db.saveDocument(fullUrl, title, html);
-
-        //  
-        sregex_iterator it(html.begin(), html.end(), regex("<a\\s+[^>]*href=\"([^\"]*)\""));
-        sregex_iterator end;
-
-        vector<Link> new_links;
-        for (; it != end; ++it) {
-            string url = (*it)[1].str();
-            if (url.empty() || url[0] == '#' || url.find("javascript:") == 0) continue;
-
-            //  URL
-            if (url.find("http") != 0) {
-                url = (url[0] == '/')
-                    ? (link.protocol == ProtocolType::HTTPS ? "https://" : "http://")
-                    + link.hostName + url
-                    : (link.protocol == ProtocolType::HTTPS ? "https://" : "http://")
-                    + link.hostName + "/" + url;
-            }
+    //  
+    size_t titleStart = html.find("<title>");
+    size_t titleEnd = html.find("</title>");
+    std::string title = (titleStart != std::string::npos && titleEnd != std::string::npos) ?
+        html.substr(titleStart + 7, titleEnd - (titleStart + 7)) : "No title";
 
-            //  URL
-            smatch url_match;
-            if (regex_match(url, url_match, regex("(https?)://([^/]+)(.*)"))) {
-                Link new_link{
-                    url_match[1] == "https" ? ProtocolType::HTTPS : ProtocolType::HTTP,
-                    url_match[2].str(),
-                    url_match[3].str().empty() ? "/" : url_match[3].str()
-                };
-                new_links.push_back(new_link);
-            }
+    //  
+    static const regex link_regex("<a\\s+[^>]*href=\"([^\"]*)\"");
+    sregex_iterator it(html.begin(), html.end(), link_regex);
+    sregex_iterator end;
+
+    vector<Link> new_links;
+    for (; it != end; ++it) {
+        string url = (*it)[1].str();
+        if (url.empty() || url[0] == '#' || url.find("javascript:") == 0) continue;
+
+        //  URL
+        if (url.find("http") != 0) {
+            url = (url[0] == '/')
+                ? (link.protocol == ProtocolType::HTTPS ? "https://" : "http://")
+                + link.hostName + url
+                : (link.protocol == ProtocolType::HTTPS ? "https://" : "http://")
+                + link.hostName + "/" + url;
         }
 
-        //     
-        if (depth > 0) {
-            lock_guard<mutex> lock(mtx);
-            for (auto& new_link : new_links) {
-                tasks.push([new_link, depth, &db]() {
-                    processLink(new_link, depth - 1, db);
-                    });
-            }
-            cv.notify_one();
+        //  URL
+        smatch url_match;
+        if (regex_match(url, url_match, regex("(https?)://([^/]+)(.*)"))) {
+            Link new_link{
+                url_match[1] == "https" ? ProtocolType::HTTPS : ProtocolType::HTTP,
+                url_match[2].str(),
+                url_match[3].str().empty() ? "/" : url_match[3].str()
+            };
+            new_links.push_back(new_link);
         }
     }
-    catch (const std::exception& e) {
-        std::cerr << "Error processing link: " << e.what() << "\n";
+
+    //     
+    if (depth > 0) {
+        vector<CrawlTask> new_tasks;
+        new_tasks.reserve(new_links.size());
+        for (auto& new_link : new_links) {
+            new_tasks.push_back({ move(new_link), depth - 1 });
+        }
+        frontier.push(checkpoint.addNew(new_tasks));
+    }
+
+    //   ,    
+    std::string fullUrl = (link.protocol == ProtocolType::HTTPS ? "https://" : "http://") +
+        link.hostName + link.query;
+    return { page.task, parseDocument(fullUrl, title, html) };
+}
+
+//  :  
+void parseWorker(Frontier& frontier, Checkpoint& checkpoint,
+    BoundedQueue<FetchedPage>& fetched, BoundedQueue<ParsedPage>& parsed, ConcurrencyLimit& limit) {
+    FetchedPage page;
+    while (true) {
+        limit.acquire();
+        if (!fetched.pop(page)) {
+            limit.release();
+            break;
+        }
+
+        std::optional<ParsedPage> result;
+        try {
+            result = parsePage(page, frontier, checkpoint);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error processing link: " << e.what() << "\n";
+            checkpoint.markDone(page.task);
+        }
+
+        //      :     
+        frontier.finish();
+        if (result) parsed.push(std::move(*result));
+        limit.release();
+    }
+}
+
+//  :   -     .
+//            --resume
+void writeWorker(Database& db, Checkpoint& checkpoint, BoundedQueue<ParsedPage>& parsed, size_t batchSize,
+    ConcurrencyLimit& limit, Autoscaler& autoscaler) {
+    vector<ParsedPage> batch;
+    vector<ParsedDocument> documents;
+    while (true) {
+        limit.acquire();
+        if (!parsed.popBatch(batch, batchSize)) {
+            limit.release();
+            break;
+        }
+
+        for (auto& page : batch) {
+            documents.push_back(std::move(page.document));
+        }
+
+        try {
+            auto started = std::chrono::steady_clock::now();
+            db.saveDocuments(documents);
+            autoscaler.recordCommit(std::chrono::steady_clock::now() - started, documents.size());
+            for (const auto& page : batch) {
+                checkpoint.markDone(page.task);
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error saving " << documents.size() << " documents: " << e.what() << "\n";
+        }
+
+        batch.clear();
+        documents.clear();
+        limit.release();
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        bool resume = argc > 1 && std::string(argv[1]) == "--resume";
+
+        //   boost::locale (to_lower, normalize)
+        std::locale::global(boost::locale::generator().generate("en_US.UTF-8"));
+
         //  
         ConfigParser config("config.ini");
 
@@ -109,17 +191,103 @@ int main() {
             config.get("database", "port"),
             config.get("database", "dbname"),
             config.get("database", "user"),
-            config.get("database", "password")
+            config.get("database", "password"),
+            config.get("database", "search_backend")
         );
 
-        //   
-        int numThreads = config.getInt("spider", "num_threads");
+        //  -  
+        std::shared_ptr<SimHashIndex> dedup;
+        int dedupDistance = config.getInt("spider", "dedup_max_distance");
+        if (dedupDistance >= 0) {
+            dedup = db.enableDeduplication(dedupDistance);
+        }
+
+        //   :      
+        auto stageBounds = [&config](const std::string& name) {
+            size_t min = std::max(config.getInt("spider", name + "_min"), 1);
+            size_t max = std::max<size_t>(config.getInt("spider", name + "_max"), min);
+            size_t initial = std::clamp<size_t>(config.getInt("spider", name), min, max);
+            return std::make_tuple(initial, min, max);
+        };
+        auto [fetchThreads, fetchMin, fetchMax] = stageBounds("fetch_threads");
+        auto [parseThreads, parseMin, parseMax] = stageBounds("parse_threads");
+        auto [dbThreads, dbMin, dbMax] = stageBounds("db_threads");
+        std::chrono::seconds autoscaleInterval(config.getInt("spider", "autoscale_interval"));
+        bool autoscale = autoscaleInterval.count() > 0;
+
+        int dbBatchSize = config.getInt("spider", "db_batch_size");
+        int queueSize = config.getInt("spider", "queue_size");
         int maxDepth = config.getInt("spider", "max_depth");
 
-        std::vector<std::thread> threadPool;
-        for (int i = 0; i < numThreads; ++i) {
-            threadPool.emplace_back(threadPoolWorker);
+        //      
+        Frontier frontier(config.get("spider", "frontier_dir"),
+            config.getInt("spider", "frontier_block_size"));
+
+        //  :  --resume   
+        Checkpoint checkpoint(config.get("spider", "checkpoint_dir"),
+            config.getInt("spider", "checkpoint_interval"));
+        if (resume) {
+            std::cout << "Resumed " << checkpoint.restore(frontier) << " pending links\n";
+        }
+        else {
+            checkpoint.clear();
         }
+        checkpoint.start();
+
+        //     ,      
+        if (!autoscale) {
+            fetchMax = fetchThreads;
+            parseMax = parseThreads;
+            dbMax = dbThreads;
+        }
+
+        //     
+        std::vector<std::unique_ptr<Database>> writerDbs;
+        for (size_t i = 0; i < dbMax; ++i) {
+            writerDbs.push_back(std::make_unique<Database>(
+                config.get("database", "host"),
+                config.get("database", "port"),
+                config.get("database", "dbname"),
+                config.get("database", "user"),
+                config.get("database", "password"),
+                config.get("database", "search_backend")
+            ));
+            if (dedup) writerDbs.back()->useDeduplication(dedup);
+        }
+
+        //   DNS:        
+        DnsCache dns(std::chrono::seconds(config.getInt("spider", "dns_ttl")),
+            std::chrono::seconds(config.getInt("spider", "dns_negative_ttl")),
+            config.getInt("spider", "dns_threads"));
+
+        BoundedQueue<FetchedPage> fetched(queueSize);
+        BoundedQueue<ParsedPage> parsed(queueSize);
+
+        //      ,    CPU
+        ConcurrencyLimit fetchLimit(fetchThreads), parseLimit(parseThreads), dbLimit(dbThreads);
+        Autoscaler autoscaler(
+            { fetchLimit, fetchMin, fetchMax },
+            { parseLimit, parseMin, parseMax },
+            { dbLimit, dbMin, dbMax },
+            [&fetched] { return static_cast<double>(fetched.size()) / fetched.capacity(); },
+            [&parsed] { return static_cast<double>(parsed.size()) / parsed.capacity(); },
+            autoscaleInterval,
+            config.getInt("spider", "autoscale_cpu_target") / 100.0);
+
+        std::vector<std::thread> fetchers, parsers, writers;
+        for (size_t i = 0; i < fetchMax; ++i) {
+            fetchers.emplace_back(fetchWorker, std::ref(frontier), std::ref(checkpoint), std::ref(dns),
+                std::ref(fetched), std::ref(fetchLimit), std::ref(autoscaler));
+        }
+        for (size_t i = 0; i < parseMax; ++i) {
+            parsers.emplace_back(parseWorker, std::ref(frontier), std::ref(checkpoint),
+                std::ref(fetched), std::ref(parsed), std::ref(parseLimit));
+        }
+        for (auto& writerDb : writerDbs) {
+            writers.emplace_back(writeWorker, std::ref(*writerDb), std::ref(checkpoint),
+                std::ref(parsed), static_cast<size_t>(dbBatchSize), std::ref(dbLimit), std::ref(autoscaler));
+        }
+        autoscaler.start();
 
         //  
         std::string startUrl = config.get("spider", "start_url");
@@ -139,27 +307,23 @@ int main() {
         startLink.query = pathPos != std::string::npos ? startUrl.substr(pathPos) : "/";
 
         //  
-        {
-            std::lock_guard<std::mutex> lock(mtx);
-            tasks.push([startLink, maxDepth, &db]() {
-                processLink(startLink, maxDepth, db);
-                });
-            cv.notify_one();
-        }
+        frontier.push(checkpoint.addNew({ { startLink, maxDepth } }));
 
         //  
         std::this_thread::sleep_for(std::chrono::seconds(10));
 
-        //  
-        {
-            std::lock_guard<std::mutex> lock(mtx);
-            exitThreadPool = true;
-            cv.notify_all();
-        }
-
-        for (auto& t : threadPool) {
-            t.join();
-        }
+        //  :    ,  .
+        //  ,          
+        //    ,     
+        frontier.close();
+        fetchLimit.close();
+        for (auto& t : fetchers) t.join();
+        fetched.close();
+        parseLimit.close();
+        for (auto& t : parsers) t.join();
+        parsed.close();
+        dbLimit.close();
+        for (auto& t : writers) t.join();
     }
     catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
@@ -0,0 +1,57 @@
+#pragma once
+#include <istream>
+#include <ostream>
+#include <string>
+#include <cstdint>
+#include "link.h"
+
+inline void writeU32(std::ostream& out, uint32_t value) {
+    char bytes[4] = {
+        static_cast<char>(value & 0xFF),
+        static_cast<char>((value >> 8) & 0xFF),
+        static_cast<char>((value >> 16) & 0xFF),
+        static_cast<char>((value >> 24) & 0xFF)
+    };
+    out.write(bytes, 4);
+}
+
+inline uint32_t readU32(std::istream& in) {
+    unsigned char bytes[4] = {};
+    in.read(reinterpret_cast<char*>(bytes), 4);
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+inline void writeU64(std::ostream& out, uint64_t value) {
+    writeU32(out, static_cast<uint32_t>(value));
+    writeU32(out, static_cast<uint32_t>(value >> 32));
+}
+
+inline uint64_t readU64(std::istream& in) {
+    uint64_t low = readU32(in);
+    return low | (static_cast<uint64_t>(readU32(in)) << 32);
+}
+
+inline void writeString(std::ostream& out, const std::string& value) {
+    writeU32(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), value.size());
+}
+
+inline std::string readString(std::istream& in) {
+    std::string value(readU32(in), '\0');
+    if (in && !value.empty()) in.read(&value[0], value.size());
+    return value;
+}
+
+inline void writeLink(std::ostream& out, const Link& link) {
+    out.put(static_cast<char>(link.protocol));
+    writeString(out, link.hostName);
+    writeString(out, link.query);
+}
+
+inline Link readLink(std::istream& in) {
+    Link link;
+    link.protocol = static_cast<ProtocolType>(in.get());
+    link.hostName = readString(in);
+    link.query = readString(in);
+    return link;
+}
@@ -0,0 +1,322 @@
+#include "search_backend.h"
+#include "database.h"
+#include <stdexcept>
+
+using namespace std;
+using namespace pqxx;
+
+namespace {
+    //  $1,$2,...  IN (...)
+    string idList(const vector<int>& ids, params& values) {
+        string list;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (i != 0) list += ",";
+            list += "$" + to_string(i + 1);
+            values.append(ids[i]);
+        }
+        return list;
+    }
+
+    //   ;      
+    string snippetData(const field& f) {
+        if (f.is_null()) return {};
+        auto bytes = f.as<basic_string<std::byte>>();
+        return string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+}
+
+unique_ptr<SearchBackend> makeSearchBackend(const string& name) {
+    if (name == "words") return make_unique<WordTableBackend>();
+    if (name == "tsvector") return make_unique<TsvectorBackend>();
+    throw runtime_error("Unknown search backend: " + name);
+}
+
+void WordTableBackend::initializeSchema(work& txn) {
+    txn.exec(R"(
+        CREATE TABLE IF NOT EXISTS words (
+            id SERIAL PRIMARY KEY,
+            word TEXT UNIQUE NOT NULL,
+            CONSTRAINT word_length CHECK (length(word) BETWEEN 3 AND 32)
+        )
+    )");
+
+    txn.exec(R"(
+        CREATE TABLE IF NOT EXISTS document_words (
+            document_id INTEGER REFERENCES documents(id) ON DELETE CASCADE,
+            word_id INTEGER REFERENCES words(id) ON DELETE CASCADE,
+            count INTEGER NOT NULL,
+            PRIMARY KEY (document_id, word_id)
+        )
+    )");
+
+    //    
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_word_text ON words(word)");
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_document_words_word ON document_words(word_id)");
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_document_words_doc ON document_words(document_id)");
+
+    //    ,    
+    txn.exec(R"(
+        CREATE TEMP TABLE IF NOT EXISTS staging_words (
+            document_id INTEGER,
+            word TEXT,
+            count INTEGER
+        ) ON COMMIT DELETE ROWS
+    )");
+}
+
+void WordTableBackend::indexDocuments(work& txn, const vector<IndexedDocument>& documents) {
+    if (documents.empty()) return;
+
+    //     COPY    ,
+    //          
+    {
+        auto stream = stream_to::table(txn, { "staging_words" }, { "document_id", "word", "count" });
+        for (const auto& [id, document] : documents) {
+            for (const auto& [word, count] : document->wordCounts) {
+                stream.write_values(id, word, count);
+            }
+        }
+        stream.complete();
+    }
+
+    //        
+    txn.exec(R"(
+        INSERT INTO words (word)
+        SELECT DISTINCT word FROM staging_words
+        ORDER BY word
+        ON CONFLICT (word) DO NOTHING
+    )");
+
+    txn.exec(R"(
+        INSERT INTO document_words (document_id, word_id, count)
+        SELECT s.document_id, w.id, s.count
+        FROM staging_words s
+        JOIN words w ON w.word = s.word
+        ON CONFLICT (document_id, word_id) DO UPDATE
+        SET count = EXCLUDED.count
+    )");
+}
+
+void WordTableBackend::removeDocuments(work& txn, const vector<int>& ids) {
+    if (ids.empty()) return;
+
+    params values;
+    string list = idList(ids, values);
+    txn.exec_params("DELETE FROM document_words WHERE document_id IN (" + list + ")", values);
+}
+
+SearchBackend::Results WordTableBackend::searchBatch(work& txn, const vector<SearchQuery>& queries) {
+    Results results(queries.size());
+    params values;
+    int n = 0;
+
+    //      SQL:   
+    //     VALUES   
+    string query_words;
+    string query_params;
+    for (size_t q = 0; q < queries.size(); ++q) {
+        for (const auto& word : queries[q].words) {
+            if (!query_words.empty()) query_words += ",";
+            query_words += "($" + to_string(n + 1) + "::int,$" + to_string(n + 2) + "::text)";
+            n += 2;
+            values.append(static_cast<int>(q));
+            values.append(word);
+        }
+
+        if (!query_params.empty()) query_params += ",";
+        query_params += "($" + to_string(n + 1) + "::int,$" + to_string(n + 2) + "::int,$"
+            + to_string(n + 3) + "::int,$" + to_string(n + 4) + "::int)";
+        n += 4;
+        values.append(static_cast<int>(q));
+        values.append(static_cast<int>(queries[q].words.size()));
+        values.append(queries[q].limit);
+        values.append(queries[q].offset);
+    }
+
+    if (query_words.empty()) return results;
+
+    string sql = R"(
+        WITH query_words (qid, word) AS (VALUES )" + query_words + R"(),
+        queries (qid, nwords, lim, off) AS (VALUES )" + query_params + R"(),
+        matched_words AS (
+            SELECT qw.qid, w.id
+            FROM query_words qw
+            JOIN words w ON w.word = qw.word
+        ),
+        relevant_docs AS (
+            SELECT mw.qid, dw.document_id, SUM(dw.count) as relevance
+            FROM document_words dw
+            JOIN matched_words mw ON dw.word_id = mw.id
+            JOIN queries q ON q.qid = mw.qid
+            GROUP BY mw.qid, dw.document_id, q.nwords
+            HAVING COUNT(DISTINCT dw.word_id) = q.nwords
+        ),
+        ranked_docs AS (
+            SELECT rd.qid, rd.document_id, rd.relevance,
+                ROW_NUMBER() OVER (PARTITION BY rd.qid
+                    ORDER BY rd.relevance DESC, rd.document_id) AS rn
+            FROM relevant_docs rd
+        )
+        SELECT r.qid, d.url, d.title, r.relevance, d.snippet
+        FROM ranked_docs r
+        JOIN queries q ON q.qid = r.qid
+        JOIN documents d ON d.id = r.document_id
+        WHERE r.rn > q.off AND r.rn <= q.off + q.lim
+        ORDER BY r.qid, r.rn
+    )";
+
+    for (const auto& row : txn.exec_params(sql, values)) {
+        results[row[0].as<int>()].emplace_back(
+            row[1].as<string>(), // url
+            row[2].as<string>(), // title
+            row[3].as<int>(),    // relevance
+            snippetData(row[4])
+        );
+    }
+
+    return results;
+}
+
+vector<pair<string, int>> WordTableBackend::wordFrequencies(work& txn) {
+    //   =  ,    
+    auto result = txn.exec(R"(
+        SELECT w.word, COUNT(dw.document_id)
+        FROM words w
+        JOIN document_words dw ON dw.word_id = w.id
+        GROUP BY w.word
+    )");
+
+    vector<pair<string, int>> frequencies;
+    frequencies.reserve(result.size());
+    for (const auto& row : result) {
+        frequencies.emplace_back(row[0].as<string>(), row[1].as<int>());
+    }
+
+    return frequencies;
+}
+
+long long WordTableBackend::indexSize(work& txn) {
+    return txn.exec(
+        "SELECT pg_total_relation_size('words') + pg_total_relation_size('document_words')"
+    )[0][0].as<long long>();
+}
+
+void TsvectorBackend::initializeSchema(work& txn) {
+    txn.exec("ALTER TABLE documents ADD COLUMN IF NOT EXISTS search_vector TSVECTOR");
+    txn.exec("CREATE INDEX IF NOT EXISTS idx_documents_search ON documents USING GIN (search_vector)");
+
+    //      COPY, tsvector   
+    txn.exec(R"(
+        CREATE TEMP TABLE IF NOT EXISTS staging_text (
+            document_id INTEGER,
+            body TEXT
+        ) ON COMMIT DELETE ROWS
+    )");
+}
+
+void TsvectorBackend::indexDocuments(work& txn, const vector<IndexedDocument>& documents) {
+    if (documents.empty()) return;
+
+    {
+        auto stream = stream_to::table(txn, { "staging_text" }, { "document_id", "body" });
+        for (const auto& [id, document] : documents) {
+            stream.write_values(id, document->text);
+        }
+        stream.complete();
+    }
+
+    txn.exec(R"(
+        UPDATE documents d
+        SET search_vector = to_tsvector('simple', s.body)
+        FROM staging_text s
+        WHERE d.id = s.document_id
+    )");
+}
+
+void TsvectorBackend::removeDocuments(work& txn, const vector<int>& ids) {
+    if (ids.empty()) return;
+
+    params values;
+    string list = idList(ids, values);
+    txn.exec_params("UPDATE documents SET search_vector = NULL WHERE id IN (" + list + ")", values);
+}
+
+SearchBackend::Results TsvectorBackend::searchBatch(work& txn, const vector<SearchQuery>& queries) {
+    Results results(queries.size());
+    params values;
+    int n = 0;
+
+    //      (plainto_tsquery),   
+    // GIN-  ,  LIMIT    ts_rank_cd
+    string query_params;
+    for (size_t q = 0; q < queries.size(); ++q) {
+        if (queries[q].words.empty()) continue;
+
+        string text;
+        for (const auto& word : queries[q].words) {
+            if (!text.empty()) text += " ";
+            text += word;
+        }
+
+        if (!query_params.empty()) query_params += ",";
+        query_params += "($" + to_string(n + 1) + "::int,$" + to_string(n + 2) + "::text,$"
+            + to_string(n + 3) + "::int,$" + to_string(n + 4) + "::int)";
+        n += 4;
+        values.append(static_cast<int>(q));
+        values.append(text);
+        values.append(queries[q].limit);
+        values.append(queries[q].offset);
+    }
+
+    if (query_params.empty()) return results;
+
+    // ts_rank_cd ,    :   
+    string sql = R"(
+        WITH queries (qid, words, lim, off) AS (VALUES )" + query_params + R"()
+        SELECT q.qid, r.url, r.title, (r.rank * 1000)::int, r.snippet
+        FROM queries q
+        CROSS JOIN LATERAL (
+            SELECT d.id, d.url, d.title, d.snippet, ts_rank_cd(d.search_vector, t.query) AS rank
+            FROM plainto_tsquery('simple', q.words) AS t(query)
+            JOIN documents d ON d.search_vector @@ t.query
+            ORDER BY rank DESC, d.id
+            LIMIT q.lim OFFSET q.off
+        ) r
+        ORDER BY q.qid, r.rank DESC, r.id
+    )";
+
+    for (const auto& row : txn.exec_params(sql, values)) {
+        results[row[0].as<int>()].emplace_back(
+            row[1].as<string>(), // url
+            row[2].as<string>(), // title
+            row[3].as<int>(),    // relevance
+            snippetData(row[4])
+        );
+    }
+
+    return results;
+}
+
+vector<pair<string, int>> TsvectorBackend::wordFrequencies(work& txn) {
+    // ts_stat       
+    auto result = txn.exec(R"(
+        SELECT word, ndoc
+        FROM ts_stat('SELECT search_vector FROM documents WHERE search_vector IS NOT NULL')
+        WHERE length(word) BETWEEN 3 AND 32
+    )");
+
+    vector<pair<string, int>> frequencies;
+    frequencies.reserve(result.size());
+    for (const auto& row : result) {
+        frequencies.emplace_back(row[0].as<string>(), row[1].as<int>());
+    }
+
+    return frequencies;
+}
+
+long long TsvectorBackend::indexSize(work& txn) {
+    return txn.exec(R"(
+        SELECT pg_relation_size('idx_documents_search')
+            + COALESCE((SELECT SUM(pg_column_size(search_vector)) FROM documents), 0)
+    )")[0][0].as<long long>();
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <pqxx/pqxx>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+struct SearchQuery;
+struct ParsedDocument;
+
+// url, title,       (snippet_text.h)
+using SearchHit = std::tuple<std::string, std::string, int, std::string>;
+
+//        documents.
+//     ,  Database.
+class SearchBackend {
+public:
+    using IndexedDocument = std::pair<int, const ParsedDocument*>;
+    using Results = std::vector<std::vector<SearchHit>>;
+
+    virtual ~SearchBackend() = default;
+
+    virtual const char* name() const = 0;
+    virtual void initializeSchema(pqxx::work& txn) = 0;
+
+    virtual void indexDocuments(pqxx::work& txn, const std::vector<IndexedDocument>& documents) = 0;
+    virtual void removeDocuments(pqxx::work& txn, const std::vector<int>& ids) = 0;
+
+    virtual Results searchBatch(pqxx::work& txn, const std::vector<SearchQuery>& queries) = 0;
+    virtual std::vector<std::pair<std::string, int>> wordFrequencies(pqxx::work& txn) = 0;
+
+    //        (  )
+    virtual long long indexSize(pqxx::work& txn) = 0;
+};
+
+//  words   document_words,    GROUP BY
+class WordTableBackend : public SearchBackend {
+public:
+    const char* name() const override { return "words"; }
+    void initializeSchema(pqxx::work& txn) override;
+    void indexDocuments(pqxx::work& txn, const std::vector<IndexedDocument>& documents) override;
+    void removeDocuments(pqxx::work& txn, const std::vector<int>& ids) override;
+    Results searchBatch(pqxx::work& txn, const std::vector<SearchQuery>& queries) override;
+    std::vector<std::pair<std::string, int>> wordFrequencies(pqxx::work& txn) override;
+    long long indexSize(pqxx::work& txn) override;
+};
+
+//  tsvector  GIN-,  ts_rank_cd.
+//  'simple'  :   ,     words
+class TsvectorBackend : public SearchBackend {
+public:
+    const char* name() const override { return "tsvector"; }
+    void initializeSchema(pqxx::work& txn) override;
+    void indexDocuments(pqxx::work& txn, const std::vector<IndexedDocument>& documents) override;
+    void removeDocuments(pqxx::work& txn, const std::vector<int>& ids) override;
+    Results searchBatch(pqxx::work& txn, const std::vector<SearchQuery>& queries) override;
+    std::vector<std::pair<std::string, int>> wordFrequencies(pqxx::work& txn) override;
+    long long indexSize(pqxx::work& txn) override;
+};
+
+std::unique_ptr<SearchBackend> makeSearchBackend(const std::string& name);
@@ -0,0 +1,87 @@
+#include "simhash.h"
+
+#include <algorithm>
+#include <bitset>
+#include <mutex>
+
+namespace {
+    // FNV-1a   :    ,
+    //        std::hash
+    uint64_t termHash(const std::string& term) {
+        uint64_t h = 1469598103934665603ULL;
+        for (unsigned char ch : term) {
+            h ^= ch;
+            h *= 1099511628211ULL;
+        }
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+}
+
+uint64_t simhash(const std::map<std::string, int>& termCounts) {
+    long long weights[64] = {};
+
+    for (const auto& [term, count] : termCounts) {
+        uint64_t h = termHash(term);
+        for (int bit = 0; bit < 64; ++bit) {
+            weights[bit] += (h >> bit) & 1 ? count : -count;
+        }
+    }
+
+    uint64_t fingerprint = 0;
+    for (int bit = 0; bit < 64; ++bit) {
+        if (weights[bit] > 0) fingerprint |= 1ULL << bit;
+    }
+    return fingerprint;
+}
+
+SimHashIndex::SimHashIndex(int maxDistance)
+    : maxDistance_(std::clamp(maxDistance, 0, 7))
+{
+    std::size_t tables = maxDistance_ + 1;
+    int shift = 0;
+    for (std::size_t t = 0; t < tables; ++t) {
+        int width = static_cast<int>(64 / tables + (t < 64 % tables ? 1 : 0));
+        shifts_.push_back(shift);
+        widths_.push_back(width);
+        shift += width;
+    }
+    tables_.resize(tables);
+}
+
+uint64_t SimHashIndex::block(uint64_t fingerprint, std::size_t table) const {
+    uint64_t mask = widths_[table] >= 64 ? ~0ULL : (1ULL << widths_[table]) - 1;
+    return (fingerprint >> shifts_[table]) & mask;
+}
+
+void SimHashIndex::add(int documentId, uint64_t fingerprint) {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    for (std::size_t t = 0; t < tables_.size(); ++t) {
+        tables_[t][block(fingerprint, t)].emplace_back(documentId, fingerprint);
+    }
+    ++size_;
+}
+
+int SimHashIndex::findNear(uint64_t fingerprint) const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    for (std::size_t t = 0; t < tables_.size(); ++t) {
+        auto it = tables_[t].find(block(fingerprint, t));
+        if (it == tables_[t].end()) continue;
+
+        for (const auto& [documentId, candidate] : it->second) {
+            if (static_cast<int>(std::bitset<64>(candidate ^ fingerprint).count()) <= maxDistance_) {
+                return documentId;
+            }
+        }
+    }
+    return -1;
+}
+
+std::size_t SimHashIndex::size() const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return size_;
+}
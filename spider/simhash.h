@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <map>
+#include <vector>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+
+//          ,
+//         
+const std::size_t SimHashMinTerms = 8;
+
+uint64_t simhash(const std::map<std::string, int>& termCounts);
+
+//       maxDistance   .
+//    maxDistance + 1 :   
+//      ,       .
+class SimHashIndex {
+public:
+    explicit SimHashIndex(int maxDistance);
+
+    void add(int documentId, uint64_t fingerprint);
+    int findNear(uint64_t fingerprint) const;
+    std::size_t size() const;
+    int maxDistance() const { return maxDistance_; }
+
+private:
+    uint64_t block(uint64_t fingerprint, std::size_t table) const;
+
+    int maxDistance_;
+    std::vector<int> shifts_;
+    std::vector<int> widths_;
+    std::vector<std::unordered_map<uint64_t, std::vector<std::pair<int, uint64_t>>>> tables_;
+    std::size_t size_ = 0;
+    mutable std::shared_mutex mtx_;
+};
@@ -0,0 +1,505 @@
+#include "snippet_text.h"
+
+#include <boost/locale.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace bl = boost::locale;
+
+namespace {
+    const std::size_t MaxTextBytes = 32 * 1024;
+    const std::size_t BlockBytes = 2048;
+
+    struct Block {
+        uint32_t firstToken;
+        uint32_t rawSize;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    //  -   , , '_'   UTF-8   ASCII
+    bool isTokenChar(unsigned char c) {
+        return c >= 0x80 || c == '_' || (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+    }
+
+    bool isSpace(unsigned char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    //   ,    ; ASCII    boost::locale
+    std::string normalizeToken(const char* data, std::size_t size) {
+        std::string token(data, size);
+        if (std::all_of(token.begin(), token.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; })) {
+            for (auto& c : token) {
+                if (c >= 'A' && c <= 'Z') c = static_cast<char>(c | 0x20);
+            }
+            return token;
+        }
+        return bl::to_lower(bl::normalize(token));
+    }
+
+    uint16_t tokenHash(const std::string& token) {
+        uint32_t hash = 2166136261u;
+        for (unsigned char c : token) {
+            hash ^= c;
+            hash *= 16777619u;
+        }
+        return static_cast<uint16_t>(hash ^ (hash >> 16));
+    }
+
+    void putVarint(std::string& out, uint32_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    bool getVarint(const std::string& in, std::size_t& pos, uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (pos >= in.size()) return false;
+            unsigned char byte = in[pos++];
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    void appendUtf8(std::string& out, uint32_t code) {
+        if (code == 0 || code > 0x10FFFF) return;
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    //     '&';    
+    std::size_t decodeEntity(const std::string& html, std::size_t pos, std::string& out) {
+        std::size_t end = html.find(';', pos);
+        if (end == std::string::npos || end - pos > 10) {
+            out += '&';
+            return pos + 1;
+        }
+
+        std::string name = html.substr(pos + 1, end - pos - 1);
+        if (name == "amp") out += '&';
+        else if (name == "lt") out += '<';
+        else if (name == "gt") out += '>';
+        else if (name == "quot") out += '"';
+        else if (name == "apos") out += '\'';
+        else if (name == "nbsp") out += ' ';
+        else if (name.size() > 1 && name[0] == '#') {
+            bool hex = name[1] == 'x' || name[1] == 'X';
+            try {
+                appendUtf8(out, static_cast<uint32_t>(std::stoul(name.substr(hex ? 2 : 1), nullptr, hex ? 16 : 10)));
+            }
+            catch (const std::exception&) {
+                out += '&';
+                return pos + 1;
+            }
+        }
+        else {
+            out += '&';
+            return pos + 1;
+        }
+        return end + 1;
+    }
+
+    std::size_t findClosingTag(const std::string& html, const std::string& name, std::size_t from) {
+        for (std::size_t pos = html.find("</", from); pos != std::string::npos; pos = html.find("</", pos + 2)) {
+            if (pos + 2 + name.size() > html.size()) break;
+            bool match = true;
+            for (std::size_t i = 0; i < name.size() && match; ++i) {
+                match = (html[pos + 2 + i] | 0x20) == name[i];
+            }
+            if (match) return pos;
+        }
+        return std::string::npos;
+    }
+
+    //    , ,   ,  .
+    //    regex: std::regex     
+    std::string plainText(const std::string& html) {
+        std::string text;
+        text.reserve(std::min(html.size(), MaxTextBytes));
+        bool pendingSpace = false;
+
+        std::size_t i = 0;
+        while (i < html.size() && text.size() <= MaxTextBytes) {
+            char c = html[i];
+            if (c == '<') {
+                if (html.compare(i, 4, "<!--") == 0) {
+                    std::size_t end = html.find("-->", i + 4);
+                    i = end == std::string::npos ? html.size() : end + 3;
+                }
+                else {
+                    std::size_t end = html.find('>', i);
+                    if (end == std::string::npos) break;
+
+                    std::string name;
+                    for (std::size_t n = i + 1; n < end && std::isalpha(static_cast<unsigned char>(html[n])); ++n) {
+                        name += static_cast<char>(html[n] | 0x20);
+                    }
+                    i = end + 1;
+
+                    if (name == "script" || name == "style" || name == "noscript" || name == "template") {
+                        std::size_t close = findClosingTag(html, name, i);
+                        std::size_t closeEnd = close == std::string::npos ? std::string::npos : html.find('>', close);
+                        i = closeEnd == std::string::npos ? html.size() : closeEnd + 1;
+                    }
+                }
+                pendingSpace = !text.empty();
+                continue;
+            }
+
+            if (isSpace(c)) {
+                pendingSpace = !text.empty();
+                ++i;
+                continue;
+            }
+
+            if (pendingSpace) {
+                text += ' ';
+                pendingSpace = false;
+            }
+
+            if (c == '&') {
+                i = decodeEntity(html, i, text);
+            }
+            else {
+                text += c;
+                ++i;
+            }
+        }
+
+        //    ,     UTF-8
+        if (text.size() > MaxTextBytes) {
+            std::size_t cut = text.rfind(' ', MaxTextBytes);
+            text.resize(cut == std::string::npos ? 0 : cut);
+        }
+        return text;
+    }
+
+    //  LZ77  ,   LZ4:     ,
+    //   inflate      10 .
+    // :   ( |  - 4), ,  2 
+    void putLength(std::string& out, std::size_t length) {
+        while (length >= 255) {
+            out += static_cast<char>(255);
+            length -= 255;
+        }
+        out += static_cast<char>(length);
+    }
+
+    bool getLength(const std::string& in, std::size_t end, std::size_t& pos, std::size_t& length) {
+        unsigned char byte;
+        do {
+            if (pos >= end) return false;
+            byte = in[pos++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    std::string compress(const char* src, std::size_t size) {
+        const int HashBits = 12;
+        std::vector<int32_t> table(1 << HashBits, -1);
+
+        std::string out;
+        out.reserve(size + size / 255 + 16);
+        std::size_t anchor = 0;
+        std::size_t i = 0;
+
+        while (i + 4 <= size) {
+            uint32_t sequence;
+            std::memcpy(&sequence, src + i, 4);
+            uint32_t hash = (sequence * 2654435761u) >> (32 - HashBits);
+            int32_t candidate = table[hash];
+            table[hash] = static_cast<int32_t>(i);
+
+            if (candidate < 0 || i - candidate > 0xFFFF || std::memcmp(src + candidate, src + i, 4) != 0) {
+                ++i;
+                continue;
+            }
+
+            std::size_t match = 4;
+            while (i + match < size && src[candidate + match] == src[i + match]) ++match;
+
+            std::size_t literals = i - anchor;
+            std::size_t extra = match - 4;
+            out += static_cast<char>((std::min<std::size_t>(literals, 15) << 4) | std::min<std::size_t>(extra, 15));
+            if (literals >= 15) putLength(out, literals - 15);
+            out.append(src + anchor, literals);
+
+            std::size_t offset = i - candidate;
+            out += static_cast<char>(offset & 0xFF);
+            out += static_cast<char>(offset >> 8);
+            if (extra >= 15) putLength(out, extra - 15);
+
+            i += match;
+            anchor = i;
+        }
+
+        //   -  
+        std::size_t literals = size - anchor;
+        out += static_cast<char>(std::min<std::size_t>(literals, 15) << 4);
+        if (literals >= 15) putLength(out, literals - 15);
+        out.append(src + anchor, literals);
+        return out;
+    }
+
+    bool decompress(const std::string& in, std::size_t pos, std::size_t size, std::size_t rawSize, std::string& out) {
+        std::size_t end = pos + size;
+        std::size_t base = out.size();
+        out.resize(base + rawSize);
+        char* dst = &out[base];
+        std::size_t op = 0;
+
+        while (pos < end) {
+            unsigned char token = in[pos++];
+
+            std::size_t literals = token >> 4;
+            if (literals == 15 && !getLength(in, end, pos, literals)) return false;
+            if (end - pos < literals || rawSize - op < literals) return false;
+            std::memcpy(dst + op, in.data() + pos, literals);
+            pos += literals;
+            op += literals;
+            if (pos == end) break;
+
+            if (end - pos < 2) return false;
+            std::size_t offset = static_cast<unsigned char>(in[pos]) | (static_cast<unsigned char>(in[pos + 1]) << 8);
+            pos += 2;
+
+            std::size_t match = token & 15;
+            if (match == 15 && !getLength(in, end, pos, match)) return false;
+            match += 4;
+            if (offset == 0 || offset > op || rawSize - op < match) return false;
+
+            //    
+            if (offset >= match) {
+                std::memcpy(dst + op, dst + op - offset, match);
+            }
+            else {
+                for (std::size_t k = 0; k < match; ++k) dst[op + k] = dst[op + k - offset];
+            }
+            op += match;
+        }
+        return op == rawSize;
+    }
+}
+
+std::string decodeHtmlText(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (std::size_t i = 0; i < text.size();) {
+        unsigned char ch = static_cast<unsigned char>(text[i]);
+        if (ch == '&') {
+            i = decodeEntity(text, i, out);
+        }
+        else if (std::isspace(ch)) {
+            if (!out.empty() && out.back() != ' ') out += ' ';
+            ++i;
+        }
+        else {
+            out += text[i++];
+        }
+    }
+    if (!out.empty() && out.back() == ' ') out.pop_back();
+    return out;
+}
+
+std::string encodeSnippetText(const std::string& html) {
+    std::string text = plainText(html);
+    if (text.empty()) return {};
+
+    //     :      
+    std::vector<uint16_t> hashes;
+    std::vector<std::pair<uint32_t, std::size_t>> blocks;   //     
+    blocks.emplace_back(0, 0);
+
+    for (std::size_t i = 0; i < text.size();) {
+        if (!isTokenChar(text[i])) {
+            if (text[i] == ' ' && i - blocks.back().second >= BlockBytes) {
+                blocks.emplace_back(static_cast<uint32_t>(hashes.size()), i);
+            }
+            ++i;
+            continue;
+        }
+
+        std::size_t end = i;
+        while (end < text.size() && isTokenChar(text[end])) ++end;
+        hashes.push_back(tokenHash(normalizeToken(text.data() + i, end - i)));
+        i = end;
+    }
+
+    std::string out;
+    putVarint(out, static_cast<uint32_t>(text.size()));
+    putVarint(out, static_cast<uint32_t>(hashes.size()));
+    for (uint16_t hash : hashes) {
+        out += static_cast<char>(hash & 0xFF);
+        out += static_cast<char>(hash >> 8);
+    }
+
+    std::string compressed;
+    putVarint(out, static_cast<uint32_t>(blocks.size()));
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        std::size_t begin = blocks[b].second;
+        std::size_t end = b + 1 < blocks.size() ? blocks[b + 1].second : text.size();
+        std::string block = compress(text.data() + begin, end - begin);
+
+        putVarint(out, blocks[b].first - (b ? blocks[b - 1].first : 0));
+        putVarint(out, static_cast<uint32_t>(end - begin));
+        putVarint(out, static_cast<uint32_t>(block.size()));
+        compressed += block;
+    }
+
+    out += compressed;
+    return out;
+}
+
+bool makeSnippet(const std::string& data, const std::vector<std::string>& words,
+    std::size_t maxTokens, Snippet& snippet) {
+    snippet.text.clear();
+    snippet.highlights.clear();
+    snippet.cutBefore = snippet.cutAfter = false;
+
+    std::size_t pos = 0;
+    uint32_t textLength, tokenCount, blockCount;
+    if (!getVarint(data, pos, textLength) || !getVarint(data, pos, tokenCount)) return false;
+    if (textLength > MaxTextBytes) return false;
+    if (tokenCount == 0 || data.size() - pos < 2ull * tokenCount) return false;
+
+    const unsigned char* hashes = reinterpret_cast<const unsigned char*>(data.data()) + pos;
+    pos += 2ull * tokenCount;
+
+    if (!getVarint(data, pos, blockCount) || blockCount == 0 || blockCount > (data.size() - pos) / 3) return false;
+    std::vector<Block> blocks(blockCount);
+    uint32_t firstToken = 0;
+    std::size_t rawTotal = 0;
+    for (auto& block : blocks) {
+        uint32_t delta, rawSize, size;
+        if (!getVarint(data, pos, delta) || !getVarint(data, pos, rawSize) || !getVarint(data, pos, size)) return false;
+        firstToken += delta;
+        rawTotal += rawSize;
+        block = { firstToken, rawSize, 0, size };
+    }
+    if (rawTotal != textLength) return false;
+    for (auto& block : blocks) {
+        if (data.size() - pos < block.size) return false;
+        block.offset = pos;
+        pos += block.size;
+    }
+
+    //       
+    std::vector<uint16_t> wordHashes;
+    for (const auto& word : words) wordHashes.push_back(tokenHash(word));
+
+    std::vector<std::pair<uint32_t, std::size_t>> hits;
+    for (uint32_t t = 0; t < tokenCount; ++t) {
+        uint16_t hash = static_cast<uint16_t>(hashes[2 * t] | (hashes[2 * t + 1] << 8));
+        for (std::size_t k = 0; k < wordHashes.size(); ++k) {
+            if (hash == wordHashes[k]) hits.emplace_back(t, k);
+        }
+    }
+
+    //   maxTokens       ,   
+    std::size_t window = std::max<std::size_t>(maxTokens, 1);
+    uint32_t start = 0;
+    if (!hits.empty()) {
+        std::vector<std::size_t> counts(words.size(), 0);
+        std::size_t distinct = 0, b = 0, bestScore = 0;
+        uint32_t bestFirst = 0, bestLast = 0;
+        for (std::size_t a = 0; a < hits.size(); ++a) {
+            while (b < hits.size() && hits[b].first < hits[a].first + window) {
+                if (counts[hits[b].second]++ == 0) ++distinct;
+                ++b;
+            }
+            std::size_t score = distinct * hits.size() + (b - a);
+            if (score > bestScore) {
+                bestScore = score;
+                bestFirst = hits[a].first;
+                bestLast = hits[b - 1].first;
+            }
+            if (--counts[hits[a].second] == 0) --distinct;
+        }
+
+        //    
+        std::size_t slack = window - (bestLast - bestFirst + 1);
+        start = bestFirst - std::min<uint32_t>(bestFirst, static_cast<uint32_t>(slack / 2));
+    }
+    uint32_t end = static_cast<uint32_t>(std::min<std::size_t>(tokenCount, start + window));
+    if (end - start < window) start = end > window ? static_cast<uint32_t>(end - window) : 0;
+
+    auto blockOf = [&blocks](uint32_t token) {
+        auto it = std::upper_bound(blocks.begin(), blocks.end(), token,
+            [](uint32_t t, const Block& block) { return t < block.firstToken; });
+        return static_cast<std::size_t>(it - blocks.begin()) - 1;
+    };
+
+    std::size_t firstBlock = blockOf(start);
+    std::size_t lastBlock = blockOf(end - 1);
+    if (firstBlock >= blocks.size() || lastBlock >= blocks.size()) return false;
+
+    std::string raw;
+    for (std::size_t b = firstBlock; b <= lastBlock; ++b) {
+        if (!decompress(data, blocks[b].offset, blocks[b].size, blocks[b].rawSize, raw)) return false;
+    }
+
+    //         
+    uint32_t token = blocks[firstBlock].firstToken;
+    std::size_t textBegin = std::string::npos, textEnd = 0;
+    std::vector<std::pair<std::size_t, std::size_t>> matched;
+    for (std::size_t i = 0; i < raw.size() && token < end;) {
+        if (!isTokenChar(raw[i])) {
+            ++i;
+            continue;
+        }
+
+        std::size_t tokenEnd = i;
+        while (tokenEnd < raw.size() && isTokenChar(raw[tokenEnd])) ++tokenEnd;
+
+        if (token >= start) {
+            if (textBegin == std::string::npos) textBegin = i;
+            textEnd = tokenEnd;
+
+            //    ,   
+            uint16_t hash = static_cast<uint16_t>(hashes[2 * token] | (hashes[2 * token + 1] << 8));
+            if (std::find(wordHashes.begin(), wordHashes.end(), hash) != wordHashes.end()) {
+                std::string normalized = normalizeToken(raw.data() + i, tokenEnd - i);
+                if (std::find(words.begin(), words.end(), normalized) != words.end()) {
+                    matched.emplace_back(i, tokenEnd - i);
+                }
+            }
+        }
+        ++token;
+        i = tokenEnd;
+    }
+    if (textBegin == std::string::npos) return false;
+
+    //         
+    while (textEnd < raw.size() && raw[textEnd] != ' ' && !isTokenChar(raw[textEnd])) ++textEnd;
+
+    snippet.text.assign(raw, textBegin, textEnd - textBegin);
+    for (const auto& [offset, length] : matched) {
+        snippet.highlights.emplace_back(static_cast<uint32_t>(offset - textBegin), static_cast<uint32_t>(length));
+    }
+    snippet.cutBefore = start > 0;
+    snippet.cutAfter = end < tokenCount;
+    return true;
+}
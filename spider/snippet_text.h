@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+//     .     
+//  ~2  (LZ77),   16-        :
+//    ,      .
+std::string encodeSnippetText(const std::string& html);
+
+//    (,  <title>):  HTML ,
+//   .    -  
+std::string decodeHtmlText(const std::string& text);
+
+struct Snippet {
+    std::string text;
+    std::vector<std::pair<uint32_t, uint32_t>> highlights;  //      text,  
+    bool cutBefore = false;
+    bool cutAfter = false;
+};
+
+// words -     .  snippet .
+// false,      
+bool makeSnippet(const std::string& data, const std::vector<std::string>& words,
+    std::size_t maxTokens, Snippet& snippet);